@@ -0,0 +1,163 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+
+// Portable 128-bit mask for boards whose square layout does not fit into 64 bits
+struct Bitboard128 {
+    uint64_t lo{0};
+    uint64_t hi{0};
+
+    friend constexpr bool operator==(const Bitboard128& left, const Bitboard128& right) = default;
+
+    constexpr explicit operator bool() const
+    {
+        return (lo | hi) != 0;
+    }
+
+    constexpr Bitboard128 operator~() const
+    {
+        return {~lo, ~hi};
+    }
+
+    constexpr Bitboard128 operator&(const Bitboard128& other) const
+    {
+        return {lo & other.lo, hi & other.hi};
+    }
+
+    constexpr Bitboard128 operator|(const Bitboard128& other) const
+    {
+        return {lo | other.lo, hi | other.hi};
+    }
+
+    constexpr Bitboard128 operator^(const Bitboard128& other) const
+    {
+        return {lo ^ other.lo, hi ^ other.hi};
+    }
+
+    constexpr Bitboard128& operator&=(const Bitboard128& other)
+    {
+        lo &= other.lo;
+        hi &= other.hi;
+        return *this;
+    }
+
+    constexpr Bitboard128& operator|=(const Bitboard128& other)
+    {
+        lo |= other.lo;
+        hi |= other.hi;
+        return *this;
+    }
+
+    constexpr Bitboard128& operator^=(const Bitboard128& other)
+    {
+        lo ^= other.lo;
+        hi ^= other.hi;
+        return *this;
+    }
+
+    constexpr Bitboard128 operator<<(int shift) const
+    {
+        if (shift == 0) {
+            return *this;
+        }
+        if (shift >= 64) {
+            return {0, lo << (shift - 64)};
+        }
+        return {lo << shift, (hi << shift) | (lo >> (64 - shift))};
+    }
+
+    constexpr Bitboard128 operator>>(int shift) const
+    {
+        if (shift == 0) {
+            return *this;
+        }
+        if (shift >= 64) {
+            return {hi >> (shift - 64), 0};
+        }
+        return {(lo >> shift) | (hi << (64 - shift)), hi >> shift};
+    }
+};
+
+// Helpers below are overloaded for uint64_t and Bitboard128 so that move generation
+// and evaluation can be written once for every board size.
+
+template <typename Mask>
+constexpr Mask squareBit(int square)
+{
+    if constexpr (std::is_same_v<Mask, uint64_t>) {
+        return uint64_t{1} << square;
+    } else {
+        return square < 64 ? Bitboard128{uint64_t{1} << square, 0} : Bitboard128{0, uint64_t{1} << (square - 64)};
+    }
+}
+
+template <typename Mask>
+constexpr bool testSquare(const Mask& mask, int square)
+{
+    return static_cast<bool>(mask & squareBit<Mask>(square));
+}
+
+// Positive values shift towards higher square indices
+template <typename Mask>
+constexpr Mask shiftBy(const Mask& mask, int shift)
+{
+    return shift >= 0 ? mask << shift : mask >> -shift;
+}
+
+constexpr int popCount(uint64_t mask)
+{
+    return std::popcount(mask);
+}
+
+constexpr int popCount(const Bitboard128& mask)
+{
+    return std::popcount(mask.lo) + std::popcount(mask.hi);
+}
+
+// Index of the least significant set bit; mask must not be empty
+constexpr int lowestSquare(uint64_t mask)
+{
+    return std::countr_zero(mask);
+}
+
+constexpr int lowestSquare(const Bitboard128& mask)
+{
+    return mask.lo != 0 ? std::countr_zero(mask.lo) : 64 + std::countr_zero(mask.hi);
+}
+
+constexpr void popLowest(uint64_t& mask)
+{
+    mask &= mask - 1;
+}
+
+constexpr void popLowest(Bitboard128& mask)
+{
+    if (mask.lo != 0) {
+        mask.lo &= mask.lo - 1;
+    } else {
+        mask.hi &= mask.hi - 1;
+    }
+}
+
+// Board stores every mask as Bitboard128; geometries that fit into 64 bits only use the low word
+template <typename Mask>
+constexpr Mask narrowMask(const Bitboard128& mask)
+{
+    if constexpr (std::is_same_v<Mask, uint64_t>) {
+        return mask.lo;
+    } else {
+        return mask;
+    }
+}
+
+template <typename Mask>
+constexpr Bitboard128 widenMask(const Mask& mask)
+{
+    if constexpr (std::is_same_v<Mask, uint64_t>) {
+        return Bitboard128{mask, 0};
+    } else {
+        return mask;
+    }
+}
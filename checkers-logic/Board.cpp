@@ -1,51 +1,127 @@
 #include "Board.hpp"
 
-#include <algorithm>
 #include <cassert>
 
+#include "Checkers.hpp"
 #include "Position.hpp"
 
-Piece& Board::operator()(int row, int col)
+int Board::squareIndex(Position pos) const
 {
-    assert((boardType_ == BOARD_TYPE::EIGHTxEIGHT ? row * static_cast<int>(boardType_) + col < 64
-            : boardType_ == BOARD_TYPE::TENxTEN   ? row * static_cast<int>(boardType_) + col < 100
-                                                  : row * static_cast<int>(boardType_) + col < 144));
-    return board_[(row * static_cast<int>(boardType_) + col) / 2];
+    assert(pos.isValid() && pos.row < getWidth() && pos.col < getWidth());
+    assert((pos.row + pos.col) % 2 == 1);
+    return toSquareIndex(getWidth(), pos.row, pos.col);
 }
 
 Piece Board::operator()(int row, int col) const
 {
-    assert((boardType_ == BOARD_TYPE::EIGHTxEIGHT ? row * static_cast<int>(boardType_) + col < 64
-            : boardType_ == BOARD_TYPE::TENxTEN   ? row * static_cast<int>(boardType_) + col < 100
-                                                  : row * static_cast<int>(boardType_) + col < 144));
-    return board_[(row * static_cast<int>(boardType_) + col) / 2];
+    return operator()(Position{row, col});
 }
 
-Piece& Board::operator()(Position pos)
+Piece Board::operator()(Position pos) const
 {
-    assert(pos.isValid());
-    return operator()(pos.row, pos.col);
+    Piece piece;
+    if ((pos.row + pos.col) % 2 == 0) {
+        // light squares are never occupied
+        return piece;
+    }
+
+    const int square = squareIndex(pos);
+    if (testSquare(captured_, square)) {
+        piece.setCaptured();
+        return piece;
+    }
+    if (testSquare(white_, square)) {
+        piece.setWhiteRegular();
+    } else if (testSquare(black_, square)) {
+        piece.setBlackRegular();
+    } else {
+        return piece;
+    }
+    if (testSquare(queens_, square)) {
+        piece.promoteToQueen();
+    }
+    return piece;
 }
 
-Piece Board::operator()(Position pos) const
+void Board::setPiece(Position pos, Piece piece)
+{
+    setEmpty(pos);
+    if (piece.isEmpty()) {
+        return;
+    }
+
+    const auto bit = squareBit<Bitboard128>(squareIndex(pos));
+    if (piece.isCaptured()) {
+        captured_ |= bit;
+        return;
+    }
+    (piece.getColour() == COLOUR::WHITE ? white_ : black_) |= bit;
+    if (piece.isQueen()) {
+        queens_ |= bit;
+    }
+}
+
+void Board::setEmpty(Position pos)
+{
+    const auto bit = ~squareBit<Bitboard128>(squareIndex(pos));
+    white_ &= bit;
+    black_ &= bit;
+    queens_ &= bit;
+    captured_ &= bit;
+}
+
+void Board::setCaptured(Position pos)
+{
+    setEmpty(pos);
+    captured_ |= squareBit<Bitboard128>(squareIndex(pos));
+}
+
+void Board::promoteToQueen(Position pos)
+{
+    assert(operator()(pos).isRegular());
+    queens_ |= squareBit<Bitboard128>(squareIndex(pos));
+}
+
+void Board::movePiece(Position from, Position to)
+{
+    assert(operator()(to).isEmpty());
+    const Piece piece = operator()(from);
+    setEmpty(from);
+    setPiece(to, piece);
+}
+
+const Bitboard128& Board::getPieces(COLOUR c) const
+{
+    return c == COLOUR::WHITE ? white_ : black_;
+}
+
+const Bitboard128& Board::getQueens() const
+{
+    return queens_;
+}
+
+void Board::setPieces(COLOUR c, const Bitboard128& pieces)
+{
+    (c == COLOUR::WHITE ? white_ : black_) = pieces;
+}
+
+void Board::setQueens(const Bitboard128& queens)
 {
-    assert(pos.isValid());
-    return operator()(pos.row, pos.col);
+    queens_ = queens;
 }
 
 void Board::setBoardType(BOARD_TYPE bt)
 {
-    assert((bt == boardType_ || std::ranges::all_of(board_, [](Piece p) {
-                return p.isEmpty();
-            })));
+    assert(bt == boardType_ || !(white_ | black_ | captured_));
     boardType_ = bt;
 }
 
 void Board::reset()
 {
-    std::ranges::for_each(board_, [](Piece& p) {
-        p.setEmpty();
-    });
+    white_ = {};
+    black_ = {};
+    queens_ = {};
+    captured_ = {};
 }
 
 int Board::getWidth() const
@@ -1,12 +1,12 @@
 #pragma once
 
-#include <array>
+#include <cstdint>
 
+#include "Bitboard.hpp"
 #include "Piece.hpp"
+#include "Position.hpp"
 
-struct Position;
-
-constexpr int MAX_BOARD_WIDTH = 72;
+enum class COLOUR;
 
 enum class BOARD_TYPE : uint8_t {
     EIGHTxEIGHT = 8,
@@ -14,16 +14,54 @@ enum class BOARD_TYPE : uint8_t {
     TWELVExTWELVE = 12,
 };
 
+/**
+ * Squares are numbered with the "ghost square" layout: only dark squares get a bit, every pair of rows
+ * takes `width + 1` bits and the extra bit is never a real square. With this layout the four diagonal
+ * neighbours of any square are always at the same bit offsets (see BoardGeometry.hpp), so whole sets of
+ * pieces can be moved with one shift. 8x8 and 10x10 fit into 64 bits, 12x12 needs 78 bits.
+ */
+constexpr int toSquareIndex(int width, int row, int col)
+{
+    return (row / 2) * (width + 1) + (row % 2) * (width / 2) + col / 2;
+}
+
+// Inverse of toSquareIndex() for real (non-ghost) squares
+constexpr Position toSquarePosition(int width, int square)
+{
+    const int half = width / 2;
+    const int pair = square / (width + 1);
+    const int offset = square % (width + 1);
+    if (offset < half) {
+        return {2 * pair, 2 * offset + 1};
+    }
+    return {2 * pair + 1, 2 * (offset - half)};
+}
+
 struct Board {
 private:
-    std::array<Piece, MAX_BOARD_WIDTH> board_{};
+    Bitboard128 white_{};
+    Bitboard128 black_{};
+    Bitboard128 queens_{};
+    // Pieces already jumped in a not finished capture chain (used by the GUI while animating)
+    Bitboard128 captured_{};
     BOARD_TYPE boardType_{BOARD_TYPE::EIGHTxEIGHT};
 
+    [[nodiscard]] int squareIndex(Position pos) const;
+
 public:
-    Piece& operator()(int row, int col);
     Piece operator()(int row, int col) const;
-    Piece& operator()(Position pos);
     Piece operator()(Position pos) const;
+    void setPiece(Position pos, Piece piece);
+    void setEmpty(Position pos);
+    void setCaptured(Position pos);
+    void promoteToQueen(Position pos);
+    void movePiece(Position from, Position to);
+
+    [[nodiscard]] const Bitboard128& getPieces(COLOUR c) const;
+    [[nodiscard]] const Bitboard128& getQueens() const;
+    void setPieces(COLOUR c, const Bitboard128& pieces);
+    void setQueens(const Bitboard128& queens);
+
     void setBoardType(BOARD_TYPE bt);
     void reset();
     [[nodiscard]] int getWidth() const;
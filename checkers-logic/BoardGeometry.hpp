@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+#include "Bitboard.hpp"
+#include "Board.hpp"
+
+/**
+ * Compile-time description of one board size in the ghost square layout (see toSquareIndex()).
+ *
+ * Diagonal neighbours are at fixed offsets: `-(half + 1)` up-left, `-half` up-right, `+half` down-left and
+ * `+(half + 1)` down-right, where `half` is the number of dark squares in a row. Shifts that leave the board
+ * either end on a ghost bit or outside of the used range and are removed with `kBoardMask`.
+ */
+template <BOARD_TYPE BT>
+struct BoardGeometry {
+    static constexpr int kWidth = static_cast<int>(BT);
+    static constexpr int kHalfWidth = kWidth / 2;
+    static constexpr int kSquareCount = kHalfWidth * (kWidth + 1);
+
+    using Mask = std::conditional_t<(kSquareCount <= 64), uint64_t, Bitboard128>;
+
+    // Same order as the {row, col} directions used by Checkers: up-left, up-right, down-left, down-right
+    static constexpr std::array<int, 4> kDirections{-(kHalfWidth + 1), -kHalfWidth, kHalfWidth, kHalfWidth + 1};
+
+    static constexpr int squareOf(int row, int col)
+    {
+        return toSquareIndex(kWidth, row, col);
+    }
+
+    static constexpr Mask rowMask(int row)
+    {
+        Mask mask{};
+        for (int col = (row % 2 ? 0 : 1); col < kWidth; col += 2) {
+            mask |= squareBit<Mask>(squareOf(row, col));
+        }
+        return mask;
+    }
+
+    static constexpr Mask kBoardMask = []() consteval {
+        Mask mask{};
+        for (int row = 0; row < kWidth; ++row) {
+            mask |= rowMask(row);
+        }
+        return mask;
+    }();
+
+    // Promotion rows: white promotes on row 0, black on the last row
+    static constexpr Mask kTopRow = rowMask(0);
+    static constexpr Mask kBottomRow = rowMask(kWidth - 1);
+
+    // Row and column of every square index, -1 for ghost squares
+    static constexpr std::array<int8_t, kSquareCount> kRowOf = []() consteval {
+        std::array<int8_t, kSquareCount> rows{};
+        rows.fill(-1);
+        for (int row = 0; row < kWidth; ++row) {
+            for (int col = (row % 2 ? 0 : 1); col < kWidth; col += 2) {
+                rows[squareOf(row, col)] = static_cast<int8_t>(row);
+            }
+        }
+        return rows;
+    }();
+
+    static constexpr std::array<int8_t, kSquareCount> kColOf = []() consteval {
+        std::array<int8_t, kSquareCount> cols{};
+        cols.fill(-1);
+        for (int row = 0; row < kWidth; ++row) {
+            for (int col = (row % 2 ? 0 : 1); col < kWidth; col += 2) {
+                cols[squareOf(row, col)] = static_cast<int8_t>(col);
+            }
+        }
+        return cols;
+    }();
+
+    // Neighbour square in each direction, -1 when the step leaves the board
+    static constexpr std::array<std::array<int8_t, 4>, kSquareCount> kNeighbour = []() consteval {
+        std::array<std::array<int8_t, 4>, kSquareCount> neighbours{};
+        for (int square = 0; square < kSquareCount; ++square) {
+            for (int dir = 0; dir < 4; ++dir) {
+                const int next = square + kDirections[dir];
+                const bool isOnBoard = kRowOf[square] >= 0 && next >= 0 && next < kSquareCount && kRowOf[next] >= 0;
+                neighbours[square][dir] = static_cast<int8_t>(isOnBoard ? next : -1);
+            }
+        }
+        return neighbours;
+    }();
+
+    static constexpr Mask shift(const Mask& mask, int dir)
+    {
+        return shiftBy(mask, kDirections[dir]) & kBoardMask;
+    }
+};
+
+// Ghost squares of the largest board, enough to index a square of any variant
+inline constexpr int kMaxSquareCount = BoardGeometry<BOARD_TYPE::TWELVExTWELVE>::kSquareCount;
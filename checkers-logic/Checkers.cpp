@@ -1,42 +1,42 @@
 #include "Checkers.hpp"
 
-#include <algorithm>
-#include <array>
 #include <cassert>
-#include <memory>
-#include <ranges>
 #include <stdexcept>
-#include <utility>
+#include <vector>
 
 #include "Board.hpp"
+#include "MoveGenerator.hpp"
 #include "Piece.hpp"
 
 namespace
 {
-size_t darkSquaresCountFor(const Board& board)
-{
-    const int width = board.getWidth();
-    return static_cast<size_t>((width * width) / 2);
-}
-
-constexpr std::array<std::pair<int, int>, 4> kMoveDirections{
-    {{-1, -1}, {-1, 1}, {1, -1}, {1, 1}}
-};
-
 constexpr size_t kMaxHistorySize = 256;
 }  // namespace
 
 Checkers::Checkers()
 {
     board_.reset();
-    validMoves_.reserve(darkSquaresCountFor(board_));
 }
 
-Checkers::Checkers(const Checkers& other) :
-    board_{other.board_}, currentColour_{other.getCurrentColour()}, checkersType_{other.checkersType_}
+Checkers::Checkers(const Checkers& other) : Checkers(other, CHECKERS_COPY::GAME)
 {
 }
 
+Checkers::Checkers(const Checkers& other, CHECKERS_COPY purpose) :
+    board_{other.board_},
+    hash_{other.hash_},
+    currentColour_{other.getCurrentColour()},
+    checkersType_{other.checkersType_}
+{
+    // a game copy is a game of its own (an engine may play it), and other.validMoves_ may be stale during a search.
+    //   A search generates the moves of every node itself
+    if (purpose == CHECKERS_COPY::GAME) {
+        generateValidMoves();
+    } else {
+        hasValidMoves_ = false;
+    }
+}
+
 void Checkers::reset()
 {
     // reset everything
@@ -68,20 +68,24 @@ void Checkers::reset()
             throw std::logic_error("Unknown CHECKERS_TYPE in Checkers::reset()");
     }
 
-    validMoves_.reserve(darkSquaresCountFor(board_));
+    Piece blackRegular;
+    blackRegular.setBlackRegular();
+    Piece whiteRegular;
+    whiteRegular.setWhiteRegular();
 
     for (int i = 0; i < lastRowBlack; ++i) {
         for (int j = (i % 2 ? 0 : 1); j < board_.getWidth(); j += 2) {
-            board_(i, j).setBlackRegular();
+            board_.setPiece({i, j}, blackRegular);
         }
     }
 
     for (int i = firstRowWhite; i < board_.getWidth(); ++i) {
         for (int j = (i % 2 ? 0 : 1); j < board_.getWidth(); j += 2) {
-            board_(i, j).setWhiteRegular();
+            board_.setPiece({i, j}, whiteRegular);
         }
     }
 
+    hash_ = computeHash();
     generateValidMoves();
     undoHistory_.clear();
     redoHistory_.clear();
@@ -109,35 +113,51 @@ void Checkers::setCheckersType(CHECKERS_TYPE ct)
             throw std::logic_error("Unknown CHECKERS_TYPE");
     }
 
-    validMoves_.reserve(darkSquaresCountFor(board_));
+    hash_ = computeHash();
+    validMoves_.clear();
     undoHistory_.clear();
     redoHistory_.clear();
 }
 
 std::vector<Move> Checkers::getValidMoves(const Position& p) const
 {
-    if (const auto it = validMoves_.find(p); it != validMoves_.end()) {
-        std::vector<Move> clonedMoves;
-        clonedMoves.reserve(it->second.size());
-        for (const auto& move : it->second) {
-            clonedMoves.push_back(cloneMove(move));
+    if (!p.isValid() || p.row >= board_.getWidth() || p.col >= board_.getWidth() || (p.row + p.col) % 2 == 0) {
+        return {};
+    }
+
+    assert(hasValidMoves_);
+    const int square = toSquareIndex(board_.getWidth(), p.row, p.col);
+    std::vector<Move> chainMoves;
+    for (const auto& move : validMoves_) {
+        if (move.from == square) {
+            chainMoves.push_back(toChainMove(move, board_.getBoardType()));
         }
-        return clonedMoves;
     }
-    return {};
+    return chainMoves;
 }
 
-const std::unordered_map<Position, std::vector<Move>>& Checkers::getValidMoves() const
+const MoveList& Checkers::getValidMoves() const
 {
+    assert(pendingUndos_ == 0 && hasValidMoves_);
     return validMoves_;
 }
 
 void Checkers::makeMove(const Move& m)
+{
+    makeMoveInternal(toFlatMove(m, board_.getBoardType()), true);
+}
+
+void Checkers::makeMove(const FlatMove& m)
 {
     makeMoveInternal(m, true);
 }
 
 void Checkers::makeMoveWithoutHistory(const Move& m)
+{
+    makeMoveInternal(toFlatMove(m, board_.getBoardType()), false);
+}
+
+void Checkers::makeMoveWithoutHistory(const FlatMove& m)
 {
     makeMoveInternal(m, false);
 }
@@ -174,6 +194,80 @@ bool Checkers::redoMove()
     return true;
 }
 
+void Checkers::doMove(const FlatMove& m, MoveUndo& undo)
+{
+    assert(testSquare(board_.getPieces(currentColour_), m.from));
+
+    undo.colour = currentColour_;
+    undo.hash = hash_;
+    hash_ ^= dispatchRules(checkersType_, currentColour_, [this, &m, &undo]<CHECKERS_TYPE CT, COLOUR C>() {
+        return MoveGenerator<CT, C>::applyMove(board_, m, undo);
+    });
+    currentColour_ = currentColour_ == COLOUR::WHITE ? COLOUR::BLACK : COLOUR::WHITE;
+    ++pendingUndos_;
+    assert(verifyHash());
+}
+
+void Checkers::undoMove(const FlatMove& m, const MoveUndo& undo)
+{
+    assert(pendingUndos_ > 0);
+
+    currentColour_ = undo.colour;
+    dispatchRules(checkersType_, currentColour_, [this, &m, &undo]<CHECKERS_TYPE CT, COLOUR C>() {
+        MoveGenerator<CT, C>::revertMove(board_, m, undo);
+    });
+    hash_ = undo.hash;
+    --pendingUndos_;
+    assert(verifyHash());
+}
+
+void Checkers::generateMoves(MoveList& moves, CAPTURE_PATHS paths) const
+{
+    moves.clear();
+    dispatchRules(checkersType_, currentColour_, [this, &moves, paths]<CHECKERS_TYPE CT, COLOUR C>() {
+        MoveGenerator<CT, C>{board_}.generate(moves, paths);
+    });
+}
+
+void Checkers::generateCaptures(MoveList& moves, CAPTURE_PATHS paths) const
+{
+    moves.clear();
+    dispatchRules(checkersType_, currentColour_, [this, &moves, paths]<CHECKERS_TYPE CT, COLOUR C>() {
+        MoveGenerator<CT, C>{board_}.generateCaptures(moves, paths);
+    });
+}
+
+void Checkers::generateQuietMoves(MoveList& moves) const
+{
+    moves.clear();
+    dispatchRules(checkersType_, currentColour_, [this, &moves]<CHECKERS_TYPE CT, COLOUR C>() {
+        MoveGenerator<CT, C>{board_}.generateQuietMoves(moves);
+    });
+}
+
+bool Checkers::hasCaptures() const
+{
+    return dispatchRules(checkersType_, currentColour_, [this]<CHECKERS_TYPE CT, COLOUR C>() {
+        return MoveGenerator<CT, C>{board_}.hasCaptures();
+    });
+}
+
+bool Checkers::hasLegalMoves() const
+{
+    return dispatchRules(checkersType_, currentColour_, [this]<CHECKERS_TYPE CT, COLOUR C>() {
+        const MoveGenerator<CT, C> generator{board_};
+        return generator.hasQuietMoves() || generator.hasCaptures();
+    });
+}
+
+bool Checkers::isLegalQuietMove(const FlatMove& m) const
+{
+    return dispatchRules(checkersType_, currentColour_, [this, &m]<CHECKERS_TYPE CT, COLOUR C>() {
+        const MoveGenerator<CT, C> generator{board_};
+        return generator.isQuietMove(m) && !generator.hasCaptures();
+    });
+}
+
 bool Checkers::canUndo() const
 {
     return !undoHistory_.empty();
@@ -184,9 +278,10 @@ bool Checkers::canRedo() const
     return !redoHistory_.empty();
 }
 
-void Checkers::makeMoveInternal(const Move& m, bool trackHistory)
+void Checkers::makeMoveInternal(const FlatMove& m, bool trackHistory)
 {
-    assert(board_(m.from).getColour() == currentColour_);
+    assert(pendingUndos_ == 0);
+    assert(testSquare(board_.getPieces(currentColour_), m.from));
 
     if (trackHistory) {
         if (undoHistory_.size() >= kMaxHistorySize) {
@@ -196,43 +291,30 @@ void Checkers::makeMoveInternal(const Move& m, bool trackHistory)
         redoHistory_.clear();
     }
 
-    // move is linked list
-    const Move* move = &m;
-    do {
-        if (move->beatenPiecePos.isValid())
-            board_(move->beatenPiecePos).setEmpty();
-        std::swap(board_(move->to), board_(move->from));
-
-        // no promotion during capture process in International checkers,
-        // but we can promote if the move is last in the seria
-        if ((checkersType_ == CHECKERS_TYPE::RUSSIAN || (!move->nextMove)) &&
-            ((move->to.row == 0 && currentColour_ == COLOUR::WHITE) ||
-             (move->to.row == board_.getWidth() - 1 && currentColour_ == COLOUR::BLACK))) {
-            if (board_(move->to).isRegular()) {
-                board_(move->to).promoteToQueen();
-            }
-        }
-        move = move->nextMove.get();
-    } while (move);
+    hash_ ^= dispatchRules(checkersType_, currentColour_, [this, &m]<CHECKERS_TYPE CT, COLOUR C>() {
+        return MoveGenerator<CT, C>::applyMove(board_, m);
+    });
 
     if (currentColour_ == COLOUR::WHITE) {
         currentColour_ = COLOUR::BLACK;
     } else {
         currentColour_ = COLOUR::WHITE;
     }
+    assert(verifyHash());
 
     generateValidMoves();
 }
 
 Checkers::GameStateSnapshot Checkers::captureSnapshot() const
 {
-    return GameStateSnapshot{.board = board_, .currentColour = currentColour_};
+    return GameStateSnapshot{.board = board_, .currentColour = currentColour_, .hash = hash_};
 }
 
 void Checkers::restoreSnapshot(const GameStateSnapshot& snapshot)
 {
     board_ = snapshot.board;
     currentColour_ = snapshot.currentColour;
+    hash_ = snapshot.hash;
     generateValidMoves();
 }
 
@@ -251,271 +333,37 @@ COLOUR Checkers::getCurrentColour() const
     return currentColour_;
 }
 
-Checkers::GameResult Checkers::getResult() const
-{
-    if (validMoves_.empty()) {
-        return {true, currentColour_ == COLOUR::WHITE ? COLOUR::BLACK : COLOUR::WHITE};
-    }
-    return {false, COLOUR::WHITE};
-}
-
-////////////////////////////////////////////////
-// PRIVATE METHODS
-
-bool Checkers::isWithinBoard(const Position& p) const
+uint64_t Checkers::getHash() const
 {
-    return p.row >= 0 && p.row < board_.getWidth() && p.col >= 0 && p.col < board_.getWidth();
+    return hash_;
 }
 
-static inline int findMaxCaptures(std::unordered_map<Position, std::vector<Move>>& moves)
+bool Checkers::verifyHash() const
 {
-    int maxCaptures = 0;
-    for (const auto& val : moves | std::views::values) {
-        for (const auto& m : val) {
-            const Move* move = &m;
-            int i = 0;
-            do {
-                ++i;
-                move = move->nextMove.get();
-            } while (move);
-            maxCaptures = std::max(i, maxCaptures);
-        }
-    }
-    return maxCaptures;
-}
-
-static inline void removeNonMaxBeatMoves(std::unordered_map<Position, std::vector<Move>>& validMoves)
-{
-    int maxCaptures = findMaxCaptures(validMoves);
-    for (auto& moves : validMoves | std::views::values) {
-        std::erase_if(moves, [maxCaptures](const Move& m) {
-            const Move* move = &m;
-            int i = 0;
-            do {
-                ++i;
-                move = move->nextMove.get();
-            } while (move);
-            return i < maxCaptures;
-        });
-    }
-
-    std::erase_if(validMoves, [](const auto& pair) {
-        return pair.second.empty();
-    });
+    return hash_ == computeHash();
 }
 
-void Checkers::generateValidMoves()
+Checkers::GameResult Checkers::getResult() const
 {
-    validMoves_.clear();
-    const int width = board_.getWidth();
-    const int darkSquaresCount = (width * width) / 2;
-
-    std::vector<Position> playerPieces;
-    playerPieces.reserve(static_cast<size_t>(darkSquaresCount));
-
-    for (int i = 0; i < width; ++i) {
-        for (int j = (i % 2 ? 0 : 1); j < width; j += 2) {
-            Piece& piece = board_(i, j);
-            if (piece.isEmpty() || piece.getColour() != currentColour_) {
-                continue;
-            }
-
-            Position pos{i, j};
-            playerPieces.push_back(pos);
-
-            std::vector<Move> moves;
-            addBeatMoves(pos, moves);
-            if (!moves.empty()) {
-                validMoves_.emplace(pos, std::move(moves));
-            }
-        }
-    }
-
-    // Save only moves with the most amount of captured pieces for INTERNATIONAL, CANADIAN and BRAZILIAN
-    if (!validMoves_.empty() && checkersType_ != CHECKERS_TYPE::RUSSIAN) {
-        removeNonMaxBeatMoves(validMoves_);
-    }
-
-    // user must beat if there is such possibility.
-    // so generate moves without captures only if there is no beat moves
+    assert(pendingUndos_ == 0 && hasValidMoves_);
     if (validMoves_.empty()) {
-        for (const Position& pos : playerPieces) {
-            std::vector<Move> moves;
-            addNonBeatMoves(pos, moves);
-            if (!moves.empty()) {
-                validMoves_.emplace(pos, std::move(moves));
-            }
-        }
-    }
-}
-
-void Checkers::addBeatMoves(const Position& p, std::vector<Move>& res) const
-{
-    if (!isWithinBoard(p)) {
-        return;
-    }
-
-    auto boardCopy = board_;
-    findCaptures(p, boardCopy, res);
-}
-
-void Checkers::findCaptures(const Position& initial, Board& boardCopy, std::vector<Move>& moves) const
-{
-    const auto piece = boardCopy(initial);
-
-    for (const auto& [dr, dc] : kMoveDirections) {
-        if (piece.isRegular()) {
-            const int enemyRow = initial.row + dr;
-            const int enemyCol = initial.col + dc;
-            if (isWithinBoard({enemyRow, enemyCol}) && boardCopy(enemyRow, enemyCol).isNotEmpty() &&
-                !boardCopy(enemyRow, enemyCol).isCaptured() &&
-                boardCopy(enemyRow, enemyCol).getColour() != piece.getColour()) {
-                const int landingRow = enemyRow + dr;
-                const int landingCol = enemyCol + dc;
-
-                if (isWithinBoard({landingRow, landingCol}) && boardCopy(landingRow, landingCol).isEmpty()) {
-                    processCapture(initial, {enemyRow, enemyCol}, {landingRow, landingCol}, boardCopy, moves);
-                }
-            }
-        } else if (piece.isQueen()) {
-            bool isNextPieceFound = false;
-            for (int enemyRow = initial.row + dr, enemyCol = initial.col + dc;
-                 !isNextPieceFound && isWithinBoard({enemyRow, enemyCol}); enemyRow += dr, enemyCol += dc) {
-                if (boardCopy(enemyRow, enemyCol).isEmpty()) {
-                    continue;
-                }
-                if (boardCopy(enemyRow, enemyCol).isCaptured() ||
-                    boardCopy(enemyRow, enemyCol).getColour() == piece.getColour()) {
-                    break;
-                }
-                isNextPieceFound = true;
-
-                for (int landingRow = enemyRow + dr, landingCol = enemyCol + dc; isWithinBoard({landingRow, landingCol});
-                     landingRow += dr, landingCol += dc) {
-                    if (boardCopy(landingRow, landingCol).isNotEmpty()) {
-                        break;
-                    }
-
-                    processCapture(initial, {enemyRow, enemyCol}, {landingRow, landingCol}, boardCopy, moves);
-                }
-                // imagine situation: queen captures one piece and can capture second piece
-                //   or can move further without capturing. The second situation is not correct,
-                //   so we remove such moves
-                removeQueenWrongMoves(initial, {enemyRow, enemyCol}, moves);
-            }
-        }
-    }
-}
-
-void Checkers::processCapture(const Position& initial, const Position& enemy, const Position& landing,
-                              const Board& boardCopy, std::vector<Move>& moves) const
-{
-    auto newBoardCopy = boardCopy;
-    std::swap(newBoardCopy(landing), newBoardCopy(initial));
-    newBoardCopy(enemy).setCaptured();
-
-    if (newBoardCopy(landing).isRegular()) {
-        auto colour = newBoardCopy(landing).getColour();
-        // no promotion during capture process in International checkers
-        if (checkersType_ == CHECKERS_TYPE::RUSSIAN && ((landing.row == 0 && colour == COLOUR::WHITE) ||
-                                                        (landing.row == board_.getWidth() - 1 && colour == COLOUR::BLACK))) {
-            newBoardCopy(landing).promoteToQueen();
-        }
-    }
-
-    auto newMove = Move{
-        .from{initial.row, initial.col},
-        .to{landing.row, landing.col},
-        .beatenPiecePos{enemy.row, enemy.col},
-        .nextMove{nullptr}
-    };
-    std::vector<Move> furtherMoves;
-    findCaptures({landing.row, landing.col}, newBoardCopy, furtherMoves);
-
-    if (!furtherMoves.empty()) {
-        // For each further move, create a separate chain
-        for (const auto& fm : furtherMoves) {
-            newMove.nextMove = cloneMovePtr(fm);
-            moves.push_back(cloneMove(newMove));
-        }
-    } else {
-        // No further captures, add the current move
-        moves.push_back(std::move(newMove));
-    };
-}
-
-void Checkers::removeQueenWrongMoves(const Position& initial, const Position& enemy, std::vector<Move>& moves) const
-{
-    bool nextBeatMoveExists{false};
-
-    for (const auto& m : moves) {
-        const Move* move = &m;
-        do {
-            if (move->from == initial && move->beatenPiecePos == enemy && move->nextMove) {
-                nextBeatMoveExists = true;
-                break;
-            }
-            move = move->nextMove.get();
-        } while (move);
-        if (nextBeatMoveExists) {
-            break;
-        }
-    }
-
-    if (nextBeatMoveExists) {
-        std::erase_if(moves, [&initial, &enemy](const Move& m) {
-            const Move* move = &m;
-            do {
-                if (move->from == initial && move->beatenPiecePos == enemy && !move->nextMove) {
-                    return true;
-                }
-                move = move->nextMove.get();
-            } while (move);
-            return false;
-        });
+        return {true, currentColour_ == COLOUR::WHITE ? COLOUR::BLACK : COLOUR::WHITE};
     }
+    return {false, COLOUR::WHITE};
 }
 
-void Checkers::addNonBeatMoves(const Position& p, std::vector<Move>& res) const
-{
-    if (board_(p).isRegular()) {
-        addOneStepMoves(p, res);
-    } else {
-        addQueenNonBeatMoves(p, res);
-    }
-}
+////////////////////////////////////////////////
+// PRIVATE METHODS
 
-void Checkers::addOneStepMoves(const Position& p, std::vector<Move>& res) const
+void Checkers::generateValidMoves()
 {
-    // check left and right moves for both sides
-    const COLOUR c = board_(p).getColour();
-    const int nextRow = p.row + (c == COLOUR::BLACK ? 1 : -1);
-    if (const int nextCol = p.col + 1; isWithinBoard({nextRow, nextCol}) && board_(nextRow, nextCol).isEmpty()) {
-        res.push_back({
-            .from{p.row,   p.col  },
-            .to{nextRow, nextCol}
-        });
-    }
-    if (const int nextCol = p.col - 1; isWithinBoard({nextRow, nextCol}) && board_(nextRow, nextCol).isEmpty()) {
-        res.push_back({
-            .from{p.row,   p.col  },
-            .to{nextRow, nextCol}
-        });
-    }
+    hasValidMoves_ = true;
+    generateMoves(validMoves_);
 }
 
-void Checkers::addQueenNonBeatMoves(const Position& p, std::vector<Move>& res) const
+uint64_t Checkers::computeHash() const
 {
-    for (const auto& [dr, dc] : kMoveDirections) {
-        for (int nextRow = p.row + dr, nextCol = p.col + dc; isWithinBoard({nextRow, nextCol});
-             nextRow += dr, nextCol += dc) {
-            if (board_(nextRow, nextCol).isNotEmpty()) {
-                break;
-            }
-            res.push_back({
-                .from{p.row,   p.col  },
-                .to{nextRow, nextCol}
-            });
-        }
-    }
+    return dispatchRules(checkersType_, currentColour_, [this]<CHECKERS_TYPE CT, COLOUR C>() {
+        return MoveGenerator<CT, C>::computeHash(board_);
+    });
 }
@@ -1,11 +1,12 @@
 #pragma once
 
+#include <cstdint>
 #include <deque>
-#include <unordered_map>
 #include <vector>
 
 #include "Board.hpp"
 #include "Move.hpp"
+#include "MoveList.hpp"
 #include "Position.hpp"
 
 enum class COLOUR {
@@ -20,53 +21,102 @@ enum class CHECKERS_TYPE {
     BRAZILIAN,
 };
 
+// How capture sequences that only differ in the order of the jumps are reported
+enum class CAPTURE_PATHS {
+    // every path separately, the GUI needs them to follow the user's clicks
+    EXACT = 0,
+    // one path per piece, set of captured pieces and final square; enough for search
+    MERGED,
+};
+
+// What a copy of a Checkers is used for
+enum class CHECKERS_COPY {
+    // a game of its own: the valid moves are generated
+    GAME = 0,
+    // only searched with doMove() and the generate*() methods; the valid moves are not generated, so
+    //   getValidMoves() and getResult() must not be called until a move is made with makeMove()
+    SEARCH,
+};
+
+// Per-ply record filled by Checkers::doMove(); holds what the move itself does not tell about the position before it
+struct MoveUndo {
+    // which of FlatMove::captured were queens
+    Bitboard128 capturedQueens{};
+    // the moving man became a queen
+    bool promoted{false};
+    // side that made the move
+    COLOUR colour{COLOUR::WHITE};
+    // Zobrist key of the position before the move
+    uint64_t hash{0};
+};
+
 class Checkers {
 private:
     struct GameStateSnapshot {
         Board board;
         COLOUR currentColour{COLOUR::WHITE};
+        uint64_t hash{0};
     };
 
     Board board_;
-    std::unordered_map<Position, std::vector<Move>> validMoves_;
+    // Zobrist key of board_ and currentColour_, kept up to date by every move
+    uint64_t hash_{0};
+    MoveList validMoves_;
     COLOUR currentColour_{COLOUR::WHITE};
     CHECKERS_TYPE checkersType_{CHECKERS_TYPE::RUSSIAN};
     std::deque<GameStateSnapshot> undoHistory_{};
     std::deque<GameStateSnapshot> redoHistory_{};
+    // doMove() calls not yet matched by undoMove(); validMoves_ describes the position only when it is 0
+    int pendingUndos_{0};
+    // false in a CHECKERS_COPY::SEARCH copy, until the valid moves are generated
+    bool hasValidMoves_{true};
 
-    [[nodiscard]] bool isWithinBoard(const Position& p) const;
     void generateValidMoves();
     [[nodiscard]] GameStateSnapshot captureSnapshot() const;
     void restoreSnapshot(const GameStateSnapshot& snapshot);
-    void makeMoveInternal(const Move& m, bool trackHistory);
-    void addBeatMoves(const Position& p, std::vector<Move>& res) const;
-    void findCaptures(const Position& initial, Board& boardCopy, std::vector<Move>& moves) const;
-    void processCapture(const Position& initial, const Position& enemy, const Position& landing, const Board& boardCopy,
-                        std::vector<Move>& moves) const;
-    void removeQueenWrongMoves(const Position& initial, const Position& enemy, std::vector<Move>& moves) const;
-    void addNonBeatMoves(const Position& p, std::vector<Move>& res) const;
-    void addOneStepMoves(const Position& p, std::vector<Move>& res) const;
-    void addQueenNonBeatMoves(const Position& p, std::vector<Move>& res) const;
+    void makeMoveInternal(const FlatMove& m, bool trackHistory);
+    [[nodiscard]] uint64_t computeHash() const;
 
 public:
     Checkers();
     Checkers(const Checkers& other);
+    Checkers(const Checkers& other, CHECKERS_COPY purpose);
     Checkers& operator=(const Checkers&) = delete;
 
     void reset();
     void setCheckersType(CHECKERS_TYPE ct);
 
+    // Moves of the piece standing on `p`, for the GUI
     [[nodiscard]] std::vector<Move> getValidMoves(const Position& p) const;
-    [[nodiscard]] const std::unordered_map<Position, std::vector<Move>>& getValidMoves() const;
+    [[nodiscard]] const MoveList& getValidMoves() const;
     void makeMove(const Move& m);
+    void makeMove(const FlatMove& m);
     void makeMoveWithoutHistory(const Move& m);
+    void makeMoveWithoutHistory(const FlatMove& m);
     bool undoMove();
     bool redoMove();
+
+    // In-place make/unmake for search: no history, no regeneration of validMoves_.
+    // Every doMove() must be undone, in reverse order, before the other methods are used again.
+    void doMove(const FlatMove& m, MoveUndo& undo);
+    void undoMove(const FlatMove& m, const MoveUndo& undo);
+    void generateMoves(MoveList& moves, CAPTURE_PATHS paths = CAPTURE_PATHS::EXACT) const;
+
+    // Pieces of the staged generation used by search (see StagedMoveGenerator)
+    void generateCaptures(MoveList& moves, CAPTURE_PATHS paths = CAPTURE_PATHS::EXACT) const;
+    void generateQuietMoves(MoveList& moves) const;
+    [[nodiscard]] bool hasCaptures() const;
+    [[nodiscard]] bool hasLegalMoves() const;
+    [[nodiscard]] bool isLegalQuietMove(const FlatMove& m) const;
+
     [[nodiscard]] bool canUndo() const;
     [[nodiscard]] bool canRedo() const;
     [[nodiscard]] const Board& getBoard() const;
     [[nodiscard]] Board getCopyBoard() const;
     [[nodiscard]] COLOUR getCurrentColour() const;
+    [[nodiscard]] uint64_t getHash() const;
+    // Debug check: the incrementally updated key matches one computed from scratch
+    [[nodiscard]] bool verifyHash() const;
 
     struct GameResult {
         bool isOver;
@@ -0,0 +1,57 @@
+#include "Move.hpp"
+
+#include <cassert>
+#include <memory>
+
+#include "Board.hpp"
+
+Move toChainMove(const FlatMove& move, BOARD_TYPE bt)
+{
+    assert(move.isValid());
+    const int width = static_cast<int>(bt);
+
+    Move chain;
+    Move* segment = &chain;
+    Position from = toSquarePosition(width, move.from);
+    for (int i = 0; i < move.stepCount; ++i) {
+        const Position to = toSquarePosition(width, move.path[i]);
+        segment->from = from;
+        segment->to = to;
+
+        if (move.isCapture()) {
+            // the jumped piece is the only captured square on the diagonal between `from` and `to`
+            const int dr = to.row > from.row ? 1 : -1;
+            const int dc = to.col > from.col ? 1 : -1;
+            for (Position p{from.row + dr, from.col + dc}; p != to; p.row += dr, p.col += dc) {
+                if (testSquare(move.captured, toSquareIndex(width, p.row, p.col))) {
+                    segment->beatenPiecePos = p;
+                    break;
+                }
+            }
+        }
+
+        if (i + 1 < move.stepCount) {
+            segment->nextMove = std::make_unique<Move>();
+            segment = segment->nextMove.get();
+        }
+        from = to;
+    }
+    return chain;
+}
+
+FlatMove toFlatMove(const Move& move, BOARD_TYPE bt)
+{
+    const int width = static_cast<int>(bt);
+
+    FlatMove flat;
+    flat.from = static_cast<uint8_t>(toSquareIndex(width, move.from.row, move.from.col));
+    for (const Move* segment = &move; segment != nullptr; segment = segment->nextMove.get()) {
+        assert(flat.stepCount < kMaxMoveSteps);
+        flat.path[flat.stepCount++] = static_cast<uint8_t>(toSquareIndex(width, segment->to.row, segment->to.col));
+        if (segment->beatenPiecePos.isValid()) {
+            flat.captured |= squareBit<Bitboard128>(
+                toSquareIndex(width, segment->beatenPiecePos.row, segment->beatenPiecePos.col));
+        }
+    }
+    return flat;
+}
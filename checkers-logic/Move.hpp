@@ -1,9 +1,15 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <memory>
+#include <type_traits>
 
+#include "Bitboard.hpp"
 #include "Position.hpp"
 
+enum class BOARD_TYPE : uint8_t;
+
 struct Move {
     Position from;
     Position to;
@@ -42,3 +48,95 @@ inline Move cloneMove(const Move& move)
     }
     return cloned;
 }
+
+// Upper bound of pieces taken by one capture sequence (every enemy piece on the 12x12 board)
+constexpr int kMaxMoveSteps = 30;
+constexpr uint8_t kNoSquare = 0xFF;
+
+/**
+ * Allocation-free move used by move generation and search. Squares are Board square indices
+ * (see toSquareIndex()); `path` holds every landing square in order, so a quiet move has one step
+ * and a capture sequence has one step per captured piece.
+ */
+struct FlatMove {
+    Bitboard128 captured{};
+    uint8_t from{kNoSquare};
+    uint8_t stepCount{0};
+    std::array<uint8_t, kMaxMoveSteps> path{};
+
+    [[nodiscard]] bool isValid() const
+    {
+        return stepCount > 0;
+    }
+
+    [[nodiscard]] bool isCapture() const
+    {
+        return static_cast<bool>(captured);
+    }
+
+    [[nodiscard]] int to() const
+    {
+        return path[stepCount - 1];
+    }
+
+    friend bool operator==(const FlatMove& left, const FlatMove& right)
+    {
+        if (left.from != right.from || left.stepCount != right.stepCount || left.captured != right.captured) {
+            return false;
+        }
+        for (int i = 0; i < left.stepCount; ++i) {
+            if (left.path[i] != right.path[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+static_assert(std::is_trivially_copyable_v<FlatMove>);
+
+/**
+ * Three-byte identity of a move for the engine's tables: origin, final square and a tag of the captured set
+ * (0 for quiet moves). It finds a move again among the generated ones; the path is not kept, which is fine
+ * because search merges chains with the same result (CAPTURE_PATHS::MERGED).
+ */
+struct PackedMove {
+    uint8_t from{kNoSquare};
+    uint8_t to{kNoSquare};
+    uint8_t captureTag{0};
+
+    static constexpr int kCaptureTagBits = 5;
+
+    [[nodiscard]] static PackedMove of(const FlatMove& move)
+    {
+        PackedMove packed;
+        packed.from = move.from;
+        packed.to = static_cast<uint8_t>(move.to());
+        if (move.isCapture()) {
+            const uint64_t folded = (move.captured.lo ^ (move.captured.hi * 0xC2B2AE3D27D4EB4FULL)) * 0x9E3779B97F4A7C15ULL;
+            packed.captureTag = static_cast<uint8_t>(1 + (folded >> (64 - kCaptureTagBits)) % ((1 << kCaptureTagBits) - 1));
+        }
+        return packed;
+    }
+
+    [[nodiscard]] bool isValid() const
+    {
+        return from != kNoSquare;
+    }
+
+    [[nodiscard]] bool isCapture() const
+    {
+        return captureTag != 0;
+    }
+
+    [[nodiscard]] bool matches(const FlatMove& move) const
+    {
+        return isValid() && move.isValid() && *this == of(move);
+    }
+
+    friend bool operator==(const PackedMove& left, const PackedMove& right) = default;
+};
+
+// Conversions between the flat form and the chained form used by the GUI
+Move toChainMove(const FlatMove& move, BOARD_TYPE bt);
+FlatMove toFlatMove(const Move& move, BOARD_TYPE bt);
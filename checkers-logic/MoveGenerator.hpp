@@ -0,0 +1,544 @@
+#pragma once
+
+#include <cassert>
+#include <stdexcept>
+
+#include "Bitboard.hpp"
+#include "Board.hpp"
+#include "BoardGeometry.hpp"
+#include "Checkers.hpp"
+#include "Move.hpp"
+#include "MoveList.hpp"
+#include "Position.hpp"
+#include "Zobrist.hpp"
+
+/**
+ * Rules that differ between the supported variants. Everything the hot paths need to know about a
+ * variant is a compile-time constant here, so MoveGenerator instantiations contain no rule branches.
+ */
+template <CHECKERS_TYPE CT>
+struct VariantRules;
+
+template <>
+struct VariantRules<CHECKERS_TYPE::RUSSIAN> {
+    static constexpr BOARD_TYPE kBoardType = BOARD_TYPE::EIGHTxEIGHT;
+    // a man reaching the last row in the middle of a capture continues the chain as a queen
+    static constexpr bool kPromotesDuringCapture = true;
+    // only the capture sequences taking the most pieces are legal
+    static constexpr bool kMustCaptureMaximum = false;
+    // capacity of a move list that fits any position of the variant
+    static constexpr size_t kMaxMoves = maxMovesForBoard(8, 12);
+};
+
+template <>
+struct VariantRules<CHECKERS_TYPE::BRAZILIAN> {
+    static constexpr BOARD_TYPE kBoardType = BOARD_TYPE::EIGHTxEIGHT;
+    static constexpr bool kPromotesDuringCapture = false;
+    static constexpr bool kMustCaptureMaximum = true;
+    static constexpr size_t kMaxMoves = maxMovesForBoard(8, 12);
+};
+
+template <>
+struct VariantRules<CHECKERS_TYPE::INTERNATIONAL> {
+    static constexpr BOARD_TYPE kBoardType = BOARD_TYPE::TENxTEN;
+    static constexpr bool kPromotesDuringCapture = false;
+    static constexpr bool kMustCaptureMaximum = true;
+    static constexpr size_t kMaxMoves = maxMovesForBoard(10, 20);
+};
+
+template <>
+struct VariantRules<CHECKERS_TYPE::CANADIAN> {
+    static constexpr BOARD_TYPE kBoardType = BOARD_TYPE::TWELVExTWELVE;
+    static constexpr bool kPromotesDuringCapture = false;
+    static constexpr bool kMustCaptureMaximum = true;
+    static constexpr size_t kMaxMoves = maxMovesForBoard(12, 30);
+};
+
+// Zobrist keys of every variant; Russian and Brazilian share the board but never the keys
+template <CHECKERS_TYPE CT>
+inline constexpr auto kZobristKeys = makeZobristTable<BoardGeometry<VariantRules<CT>::kBoardType>::kSquareCount>(
+    0x5DEECE66DULL * (static_cast<uint64_t>(CT) + 1));
+
+/**
+ * Move generation and move application for one variant and one side to move, on top of the bitboards
+ * stored in Board. Promotion rows, forward directions and the variant rules are template constants.
+ */
+template <CHECKERS_TYPE CT, COLOUR C>
+class MoveGenerator {
+private:
+    using Rules = VariantRules<CT>;
+    using Geometry = BoardGeometry<Rules::kBoardType>;
+    using Mask = typename Geometry::Mask;
+
+    static constexpr COLOUR kEnemy = C == COLOUR::WHITE ? COLOUR::BLACK : COLOUR::WHITE;
+    static constexpr Mask kPromotionRow = C == COLOUR::WHITE ? Geometry::kTopRow : Geometry::kBottomRow;
+    // white men go up the board (directions 0 and 1), black men go down (directions 2 and 3)
+    static constexpr int kFirstForwardDir = C == COLOUR::WHITE ? 0 : 2;
+
+    // Board seen by the capture search: jumped pieces stay on the board until the chain is finished.
+    // One instance is changed in place while walking the chains and restored on backtrack.
+    struct CaptureBoard {
+        Mask own;
+        Mask enemy;
+        Mask queens;
+        Mask captured;
+    };
+
+    // State of one capture generation: the board, the chain walked so far and, for the variants that only
+    // allow the longest sequences, the length of the longest finished chain found yet
+    struct CaptureWalk {
+        CaptureBoard board;
+        FlatMove current;
+        int longestChain{0};
+        CAPTURE_PATHS paths{CAPTURE_PATHS::EXACT};
+    };
+
+    const Mask own_;
+    const Mask enemy_;
+    const Mask queens_;
+    const Mask empty_;
+
+    // Men that have an enemy piece next to them and an empty square right behind it
+    [[nodiscard]] Mask menWithCaptures() const
+    {
+        const Mask men = own_ & ~queens_;
+        Mask result{};
+        for (int dir = 0; dir < 4; ++dir) {
+            const int back = 3 - dir;
+            result |= men & Geometry::shift(enemy_ & Geometry::shift(empty_, back), back);
+        }
+        return result;
+    }
+
+    // Jumps the piece on `from` over `enemy` to `landing`; returns whether a man was promoted on the way
+    static bool markCapture(CaptureBoard& board, bool isQueen, int from, int enemy, int landing)
+    {
+        const Mask moved = squareBit<Mask>(from) | squareBit<Mask>(landing);
+        board.own ^= moved;
+        board.captured |= squareBit<Mask>(enemy);
+        if (isQueen) {
+            board.queens ^= moved;
+        } else if constexpr (Rules::kPromotesDuringCapture) {
+            if (testSquare(kPromotionRow, landing)) {
+                board.queens |= squareBit<Mask>(landing);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static void unmarkCapture(CaptureBoard& board, bool isQueen, int from, int enemy, int landing, bool promoted)
+    {
+        const Mask moved = squareBit<Mask>(from) | squareBit<Mask>(landing);
+        if (isQueen) {
+            board.queens ^= moved;
+        } else if (promoted) {
+            board.queens &= ~squareBit<Mask>(landing);
+        }
+        board.captured &= ~squareBit<Mask>(enemy);
+        board.own ^= moved;
+    }
+
+    // Walks every chain going on from `initial`; returns whether the piece there can capture anything
+    template <typename List>
+    bool findCaptures(int initial, CaptureWalk& walk, List& moves) const
+    {
+        CaptureBoard& board = walk.board;
+        const Mask occupied = board.own | board.enemy;
+        const Mask targets = board.enemy & ~board.captured;
+
+        if constexpr (Rules::kMustCaptureMaximum) {
+            // Even capturing every remaining piece cannot catch up with the longest chain: nothing from here
+            // on will be kept. Reporting a capture keeps the callers from recording the shorter chain as well.
+            if (walk.current.stepCount + popCount(targets) < walk.longestChain) {
+                return true;
+            }
+        }
+
+        const bool isQueen = testSquare(board.queens, initial);
+        bool canCapture = false;
+        for (int dir = 0; dir < 4; ++dir) {
+            if (!isQueen) {
+                const int enemy = Geometry::kNeighbour[initial][dir];
+                if (enemy < 0 || !testSquare(targets, enemy)) {
+                    continue;
+                }
+                if (const int landing = Geometry::kNeighbour[enemy][dir]; landing >= 0 && !testSquare(occupied, landing)) {
+                    canCapture = true;
+                    processCapture(false, initial, enemy, landing, walk, moves);
+                }
+            } else {
+                int enemy = Geometry::kNeighbour[initial][dir];
+                while (enemy >= 0 && !testSquare(occupied, enemy)) {
+                    enemy = Geometry::kNeighbour[enemy][dir];
+                }
+                // board edge, own piece or already captured piece stops the queen
+                if (enemy < 0 || !testSquare(targets, enemy)) {
+                    continue;
+                }
+                const int firstLanding = Geometry::kNeighbour[enemy][dir];
+                if (firstLanding < 0 || testSquare(occupied, firstLanding)) {
+                    continue;
+                }
+                canCapture = true;
+
+                // imagine situation: queen captures one piece and can capture second piece
+                //   or can move further without capturing. The second situation is not correct,
+                //   so the queen may stop after this capture only if no landing square lets the chain go on.
+                bool chainGoesOn = false;
+                for (int landing = firstLanding; landing >= 0 && !testSquare(occupied, landing);
+                     landing = Geometry::kNeighbour[landing][dir]) {
+                    chainGoesOn |= processCapture<false>(true, initial, enemy, landing, walk, moves);
+                }
+                if (!chainGoesOn) {
+                    for (int landing = firstLanding; landing >= 0 && !testSquare(occupied, landing);
+                         landing = Geometry::kNeighbour[landing][dir]) {
+                        walk.current.path[walk.current.stepCount++] = static_cast<uint8_t>(landing);
+                        recordChain(board.captured | squareBit<Mask>(enemy), walk, moves);
+                        --walk.current.stepCount;
+                    }
+                }
+            }
+        }
+        return canCapture;
+    }
+
+    // Adds the finished chain `walk.current`, unless a longer one is already known and only the longest count
+    template <typename List>
+    static void recordChain(Mask captured, CaptureWalk& walk, List& moves)
+    {
+        if constexpr (Rules::kMustCaptureMaximum) {
+            if (walk.current.stepCount < walk.longestChain) {
+                return;
+            }
+            if (walk.current.stepCount > walk.longestChain) {
+                // everything found so far is shorter and not legal any more
+                walk.longestChain = walk.current.stepCount;
+                moves.clear();
+            }
+        }
+        walk.current.captured = widenMask(captured);
+        if (walk.paths == CAPTURE_PATHS::MERGED) {
+            for (const auto& m : moves) {
+                if (isSameResult(m, walk.current)) {
+                    return;
+                }
+            }
+        }
+        moves.push_back(walk.current);
+    }
+
+    // Captures that leave the same position behind: same piece, same captured pieces, same final square and,
+    // where a man can be promoted in the middle of a chain, the same promotion
+    static bool isSameResult(const FlatMove& left, const FlatMove& right)
+    {
+        if (left.from != right.from || left.to() != right.to() || left.captured != right.captured) {
+            return false;
+        }
+        if constexpr (Rules::kPromotesDuringCapture) {
+            return reachesPromotionRow(left) == reachesPromotionRow(right);
+        }
+        return true;
+    }
+
+    // `walk` holds the chain made so far; it is extended in place and restored before returning.
+    // Returns whether the chain goes on after this capture. When it does not, the finished sequence is recorded
+    // only if `MayStop`, otherwise the caller decides.
+    template <bool MayStop = true, typename List>
+    bool processCapture(bool isQueen, int initial, int enemy, int landing, CaptureWalk& walk, List& moves) const
+    {
+        const bool promoted = markCapture(walk.board, isQueen, initial, enemy, landing);
+        walk.current.path[walk.current.stepCount++] = static_cast<uint8_t>(landing);
+
+        const bool chainGoesOn = findCaptures(landing, walk, moves);
+        if (!chainGoesOn && MayStop) {
+            // No further captures, the sequence ends here
+            recordChain(walk.board.captured, walk, moves);
+        }
+
+        --walk.current.stepCount;
+        unmarkCapture(walk.board, isQueen, initial, enemy, landing, promoted);
+        return chainGoesOn;
+    }
+
+    static FlatMove makeQuietMove(int from, int to)
+    {
+        FlatMove move;
+        move.from = static_cast<uint8_t>(from);
+        move.path[0] = static_cast<uint8_t>(to);
+        move.stepCount = 1;
+        return move;
+    }
+
+    // A man promotes when the move ends on the last row, in Russian checkers also when a capture passes it
+    static bool reachesPromotionRow(const FlatMove& move)
+    {
+        if constexpr (Rules::kPromotesDuringCapture) {
+            for (int i = 0; i < move.stepCount; ++i) {
+                if (testSquare(kPromotionRow, move.path[i])) {
+                    return true;
+                }
+            }
+            return false;
+        } else {
+            return testSquare(kPromotionRow, move.to());
+        }
+    }
+
+    template <typename List>
+    void addMenMoves(List& moves) const
+    {
+        const Mask men = own_ & ~queens_;
+        for (int dir = kFirstForwardDir; dir < kFirstForwardDir + 2; ++dir) {
+            Mask targets = Geometry::shift(men, dir) & empty_;
+            while (targets) {
+                const int to = lowestSquare(targets);
+                popLowest(targets);
+                const int from = to - Geometry::kDirections[dir];
+                moves.push_back(makeQuietMove(from, to));
+            }
+        }
+    }
+
+    template <typename List>
+    void addQueenMoves(List& moves) const
+    {
+        Mask queens = own_ & queens_;
+        while (queens) {
+            const int from = lowestSquare(queens);
+            popLowest(queens);
+
+            for (int dir = 0; dir < 4; ++dir) {
+                for (Mask ray = Geometry::shift(squareBit<Mask>(from), dir) & empty_; ray;
+                     ray = Geometry::shift(ray, dir) & empty_) {
+                    moves.push_back(makeQuietMove(from, lowestSquare(ray)));
+                }
+            }
+        }
+    }
+
+public:
+    explicit MoveGenerator(const Board& board) :
+        own_{narrowMask<Mask>(board.getPieces(C))},
+        enemy_{narrowMask<Mask>(board.getPieces(kEnemy))},
+        queens_{narrowMask<Mask>(board.getQueens())},
+        empty_{Geometry::kBoardMask & ~(own_ | enemy_)}
+    {
+    }
+
+    // Fills the empty list `moves` with every legal move of the position
+    template <size_t Capacity>
+    void generate(BasicMoveList<Capacity>& moves, CAPTURE_PATHS paths = CAPTURE_PATHS::EXACT) const
+    {
+        generateCaptures(moves, paths);
+        // user must beat if there is such possibility.
+        // so generate moves without captures only if there is no beat moves
+        if (moves.empty()) {
+            generateQuietMoves(moves);
+        }
+    }
+
+    // Fills the empty list `moves` with the legal capture sequences
+    template <size_t Capacity>
+    void generateCaptures(BasicMoveList<Capacity>& moves, CAPTURE_PATHS paths = CAPTURE_PATHS::EXACT) const
+    {
+        static_assert(Capacity >= Rules::kMaxMoves, "move list is too small for this variant");
+        assert(moves.empty());
+
+        // Only queens and men standing next to a capturable piece can start a capture chain.
+        // For INTERNATIONAL, CANADIAN and BRAZILIAN only the chains with the most captured pieces are kept,
+        // shorter ones are dropped while walking (see recordChain()).
+        Mask capturers = (own_ & queens_) | menWithCaptures();
+        CaptureWalk walk{CaptureBoard{own_, enemy_, queens_, Mask{}}, FlatMove{}, 0, paths};
+        while (capturers) {
+            const int square = lowestSquare(capturers);
+            popLowest(capturers);
+
+            walk.current.from = static_cast<uint8_t>(square);
+            findCaptures(square, walk, moves);
+        }
+    }
+
+    // Fills the empty list `moves` with the moves without captures; they are legal only if hasCaptures() is false
+    template <size_t Capacity>
+    void generateQuietMoves(BasicMoveList<Capacity>& moves) const
+    {
+        static_assert(Capacity >= Rules::kMaxMoves, "move list is too small for this variant");
+        assert(moves.empty());
+
+        addMenMoves(moves);
+        addQueenMoves(moves);
+    }
+
+    // Whether any piece can capture, without enumerating the sequences
+    [[nodiscard]] bool hasCaptures() const
+    {
+        const Mask men = own_ & ~queens_;
+        for (int dir = 0; dir < 4; ++dir) {
+            // squares a queen slides over plus the first occupied square in this direction
+            Mask reach = Geometry::shift(own_ & queens_, dir);
+            for (Mask run = reach & empty_; run; run = Geometry::shift(run, dir) & empty_) {
+                reach |= Geometry::shift(run, dir);
+            }
+            reach |= Geometry::shift(men, dir);
+            if (Geometry::shift(reach & enemy_, dir) & empty_) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    [[nodiscard]] bool hasQuietMoves() const
+    {
+        const Mask men = own_ & ~queens_;
+        const Mask queens = own_ & queens_;
+        for (int dir = 0; dir < 4; ++dir) {
+            const bool isForward = dir == kFirstForwardDir || dir == kFirstForwardDir + 1;
+            if (Geometry::shift(isForward ? men | queens : queens, dir) & empty_) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Whether `move` is a move without captures available on this board (captures may still be mandatory)
+    [[nodiscard]] bool isQuietMove(const FlatMove& move) const
+    {
+        if (move.stepCount != 1 || move.isCapture() || !testSquare(own_, move.from) || !testSquare(empty_, move.to())) {
+            return false;
+        }
+        const bool isQueen = testSquare(queens_, move.from);
+        for (int dir = 0; dir < 4; ++dir) {
+            if (!isQueen && dir != kFirstForwardDir && dir != kFirstForwardDir + 1) {
+                continue;
+            }
+            for (int square = Geometry::kNeighbour[move.from][dir]; square >= 0 && testSquare(empty_, square);
+                 square = Geometry::kNeighbour[square][dir]) {
+                if (square == move.to()) {
+                    return true;
+                }
+                if (!isQueen) {
+                    break;
+                }
+            }
+        }
+        return false;
+    }
+
+    static uint64_t pieceKey(COLOUR colour, bool isQueen, int square)
+    {
+        if (colour == COLOUR::WHITE) {
+            return kZobristKeys<CT>.pieceKey(isQueen ? ZOBRIST_PIECE::WHITE_QUEEN : ZOBRIST_PIECE::WHITE_REGULAR, square);
+        }
+        return kZobristKeys<CT>.pieceKey(isQueen ? ZOBRIST_PIECE::BLACK_QUEEN : ZOBRIST_PIECE::BLACK_REGULAR, square);
+    }
+
+    // Zobrist key of `board` with C to move, computed from scratch
+    static uint64_t computeHash(const Board& board)
+    {
+        const Mask queens = narrowMask<Mask>(board.getQueens());
+        uint64_t hash = C == COLOUR::BLACK ? kZobristKeys<CT>.sideToMove : 0;
+        for (const COLOUR colour : {COLOUR::WHITE, COLOUR::BLACK}) {
+            Mask pieces = narrowMask<Mask>(board.getPieces(colour));
+            while (pieces) {
+                const int square = lowestSquare(pieces);
+                popLowest(pieces);
+                hash ^= pieceKey(colour, testSquare(queens, square), square);
+            }
+        }
+        return hash;
+    }
+
+    // Applies `move` and stores in `undo` what revertMove() needs to restore the board.
+    // Returns the value to XOR into the Zobrist key of the position.
+    static uint64_t applyMove(Board& board, const FlatMove& move, MoveUndo& undo)
+    {
+        Mask own = narrowMask<Mask>(board.getPieces(C));
+        Mask enemy = narrowMask<Mask>(board.getPieces(kEnemy));
+        Mask queens = narrowMask<Mask>(board.getQueens());
+        const Mask captured = narrowMask<Mask>(move.captured);
+        const Mask fromBit = squareBit<Mask>(move.from);
+        const Mask toBit = squareBit<Mask>(move.to());
+
+        undo.capturedQueens = widenMask(queens & captured);
+        undo.promoted = false;
+
+        uint64_t hashDelta = kZobristKeys<CT>.sideToMove;
+        for (Mask pieces = captured; pieces; popLowest(pieces)) {
+            const int square = lowestSquare(pieces);
+            hashDelta ^= pieceKey(kEnemy, testSquare(queens, square), square);
+        }
+
+        enemy &= ~captured;
+        queens &= ~captured;
+        // a queen may finish a capture sequence on its own starting square
+        own = (own & ~fromBit) | toBit;
+        const bool wasQueen = testSquare(queens, move.from);
+        if (wasQueen) {
+            queens = (queens & ~fromBit) | toBit;
+        } else if (reachesPromotionRow(move)) {
+            queens |= toBit;
+            undo.promoted = true;
+        }
+        hashDelta ^= pieceKey(C, wasQueen, move.from) ^ pieceKey(C, wasQueen || undo.promoted, move.to());
+
+        board.setPieces(C, widenMask(own));
+        board.setPieces(kEnemy, widenMask(enemy));
+        board.setQueens(widenMask(queens));
+        return hashDelta;
+    }
+
+    static uint64_t applyMove(Board& board, const FlatMove& move)
+    {
+        MoveUndo undo;
+        return applyMove(board, move, undo);
+    }
+
+    // Exact inverse of applyMove(board, move, undo)
+    static void revertMove(Board& board, const FlatMove& move, const MoveUndo& undo)
+    {
+        Mask own = narrowMask<Mask>(board.getPieces(C));
+        Mask enemy = narrowMask<Mask>(board.getPieces(kEnemy));
+        Mask queens = narrowMask<Mask>(board.getQueens());
+        const Mask fromBit = squareBit<Mask>(move.from);
+        const Mask toBit = squareBit<Mask>(move.to());
+
+        if (undo.promoted) {
+            queens &= ~toBit;
+        } else if (testSquare(queens, move.to())) {
+            queens = (queens & ~toBit) | fromBit;
+        }
+        own = (own & ~toBit) | fromBit;
+        enemy |= narrowMask<Mask>(move.captured);
+        queens |= narrowMask<Mask>(undo.capturedQueens);
+
+        board.setPieces(C, widenMask(own));
+        board.setPieces(kEnemy, widenMask(enemy));
+        board.setQueens(widenMask(queens));
+    }
+};
+
+// Runtime boundary: calls `f.template operator()<CT, C>()` for the given variant and side to move
+template <typename F>
+decltype(auto) dispatchRules(CHECKERS_TYPE checkersType, COLOUR colour, F&& f)
+{
+    const auto withColour = [colour, &f]<CHECKERS_TYPE CT>() -> decltype(auto) {
+        if (colour == COLOUR::WHITE) {
+            return f.template operator()<CT, COLOUR::WHITE>();
+        }
+        return f.template operator()<CT, COLOUR::BLACK>();
+    };
+
+    switch (checkersType) {
+        case CHECKERS_TYPE::RUSSIAN:
+            return withColour.template operator()<CHECKERS_TYPE::RUSSIAN>();
+        case CHECKERS_TYPE::INTERNATIONAL:
+            return withColour.template operator()<CHECKERS_TYPE::INTERNATIONAL>();
+        case CHECKERS_TYPE::CANADIAN:
+            return withColour.template operator()<CHECKERS_TYPE::CANADIAN>();
+        case CHECKERS_TYPE::BRAZILIAN:
+            return withColour.template operator()<CHECKERS_TYPE::BRAZILIAN>();
+        default:
+            throw std::logic_error("Unknown CHECKERS_TYPE");
+    }
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+
+#include "Move.hpp"
+
+/**
+ * Contiguous list of FlatMove with a fixed capacity and inline storage, so generating moves never
+ * allocates. The storage is left uninitialised; only the first `size()` elements are live. Pushing past the
+ * capacity throws std::length_error: a move is never dropped silently.
+ */
+template <size_t Capacity>
+class BasicMoveList {
+private:
+    alignas(FlatMove) std::byte storage_[Capacity * sizeof(FlatMove)];
+    size_t size_{0};
+
+public:
+    static constexpr size_t kCapacity = Capacity;
+
+    BasicMoveList() = default;
+
+    BasicMoveList(const BasicMoveList& other) : size_{other.size_}
+    {
+        std::copy(other.begin(), other.end(), begin());
+    }
+
+    BasicMoveList& operator=(const BasicMoveList& other)
+    {
+        size_ = other.size_;
+        std::copy(other.begin(), other.end(), begin());
+        return *this;
+    }
+
+    void push_back(const FlatMove& move)
+    {
+        if (size_ == Capacity) {
+            throw std::length_error("BasicMoveList is full, the position has more moves than its capacity");
+        }
+        std::construct_at(begin() + size_, move);
+        ++size_;
+    }
+
+    void pop_back()
+    {
+        assert(size_ > 0);
+        --size_;
+    }
+
+    // Removes [first, last), keeping the order of the remaining moves
+    void erase(FlatMove* first, FlatMove* last)
+    {
+        std::copy(last, end(), first);
+        size_ -= static_cast<size_t>(last - first);
+    }
+
+    void clear()
+    {
+        size_ = 0;
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        return size_;
+    }
+
+    [[nodiscard]] bool empty() const
+    {
+        return size_ == 0;
+    }
+
+    FlatMove* begin()
+    {
+        return std::launder(reinterpret_cast<FlatMove*>(storage_));
+    }
+
+    FlatMove* end()
+    {
+        return begin() + size_;
+    }
+
+    [[nodiscard]] const FlatMove* begin() const
+    {
+        return std::launder(reinterpret_cast<const FlatMove*>(storage_));
+    }
+
+    [[nodiscard]] const FlatMove* end() const
+    {
+        return begin() + size_;
+    }
+
+    FlatMove& operator[](size_t i)
+    {
+        assert(i < size_);
+        return begin()[i];
+    }
+
+    const FlatMove& operator[](size_t i) const
+    {
+        assert(i < size_);
+        return begin()[i];
+    }
+};
+
+/**
+ * Upper bound of quiet moves for a board of the given width: every piece of one side as a queen with the
+ * most quiet moves a queen can have (2 * width - 3, from a central square). Capture sequences are not covered
+ * by the proof: they are far fewer in practice, but CAPTURE_PATHS::EXACT lists every order of the jumps, and
+ * an adversarial position could exceed it. BasicMoveList::push_back() throws then.
+ */
+constexpr size_t maxMovesForBoard(int width, int piecesPerSide)
+{
+    return static_cast<size_t>(piecesPerSide * (2 * width - 3));
+}
+
+// Capacity that fits every variant, used where the variant is only known at runtime
+constexpr size_t kMaxMovesPerPosition = maxMovesForBoard(12, 30);
+
+using MoveList = BasicMoveList<kMaxMovesPerPosition>;
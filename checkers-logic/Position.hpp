@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 
 struct Position {
@@ -25,6 +26,9 @@ template <>
 struct std::hash<Position> {
     size_t operator()(const Position& pos) const noexcept
     {
-        return hash<int>()(pos.row) ^ (hash<int>()(pos.col) << 1);
+        // rows and columns are small and non-negative for real squares; keep them in separate halves
+        //   so that e.g. (0, 2) and (4, 0) do not collide
+        const auto packed = (static_cast<uint64_t>(static_cast<uint32_t>(pos.row)) << 32) | static_cast<uint32_t>(pos.col);
+        return hash<uint64_t>()(packed);
     }
 };  // namespace std
@@ -0,0 +1,160 @@
+#include "StagedMoveGenerator.hpp"
+
+#include <algorithm>
+
+#include "Checkers.hpp"
+
+namespace
+{
+FlatMove toQuietMove(PackedMove move)
+{
+    FlatMove quiet;
+    quiet.from = move.from;
+    quiet.path[0] = move.to;
+    quiet.stepCount = 1;
+    return quiet;
+}
+}  // namespace
+
+StagedMoveGenerator::StagedMoveGenerator(const Checkers& position, MoveList& moves, PackedMove hashMove,
+                                         const KillerMoves& killers, const HistoryScores* history) :
+    position_{position}, moves_{moves}, hashMove_{hashMove}, killers_{killers}, history_{history}
+{
+}
+
+const FlatMove* StagedMoveGenerator::next()
+{
+    while (true) {
+        switch (stage_) {
+            case STAGE::HASH_MOVE:
+                // A quiet hash move is verified without generating anything and, when legal, there are no
+                // captures to look at. A capture hash move is moved to the front of the capture stage instead.
+                stage_ = STAGE::GENERATE_CAPTURES;
+                if (hashMove_.isValid() && !hashMove_.isCapture()) {
+                    quietHashMove_ = toQuietMove(hashMove_);
+                    if (position_.isLegalQuietMove(quietHashMove_)) {
+                        hashMoveReturned_ = true;
+                        stage_ = STAGE::KILLER_MOVES;
+                        return &quietHashMove_;
+                    }
+                }
+                break;
+
+            case STAGE::GENERATE_CAPTURES:
+                position_.generateCaptures(moves_, CAPTURE_PATHS::MERGED);
+                index_ = 0;
+                // captures are mandatory, so quiet moves are only generated when there are none
+                stage_ = moves_.empty() ? STAGE::KILLER_MOVES : STAGE::CAPTURES;
+                if (hashMove_.isCapture()) {
+                    const auto it = std::find_if(moves_.begin(), moves_.end(), [this](const FlatMove& m) {
+                        return hashMove_.matches(m);
+                    });
+                    if (it != moves_.end()) {
+                        std::rotate(moves_.begin(), it, it + 1);
+                    }
+                }
+                break;
+
+            case STAGE::KILLER_MOVES:
+                if (const FlatMove* move = nextKiller()) {
+                    return move;
+                }
+                stage_ = STAGE::GENERATE_QUIET_MOVES;
+                break;
+
+            case STAGE::GENERATE_QUIET_MOVES:
+                position_.generateQuietMoves(moves_);
+                index_ = 0;
+                stage_ = STAGE::QUIET_MOVES;
+                break;
+
+            case STAGE::CAPTURES:
+            case STAGE::QUIET_MOVES:
+                if (const FlatMove* move = nextFromList()) {
+                    return move;
+                }
+                stage_ = STAGE::DONE;
+                break;
+
+            case STAGE::DONE:
+                return nullptr;
+        }
+    }
+}
+
+StagedMoveGenerator::STAGE StagedMoveGenerator::getStage() const
+{
+    return stage_;
+}
+
+// Killers come from sibling positions, so each one is checked like the quiet hash move
+const FlatMove* StagedMoveGenerator::nextKiller()
+{
+    while (killerIndex_ < killers_.size()) {
+        const size_t i = killerIndex_++;
+        const PackedMove killer = killers_[i];
+        if (!killer.isValid() || killer.isCapture()) {
+            continue;
+        }
+        killerMoves_[i] = toQuietMove(killer);
+        if (!wasReturned(killerMoves_[i]) && position_.isLegalQuietMove(killerMoves_[i])) {
+            killerReturned_[i] = true;
+            return &killerMoves_[i];
+        }
+    }
+    return nullptr;
+}
+
+bool StagedMoveGenerator::isSingleReply() const
+{
+    // the lists of these stages hold every move of the position
+    return (stage_ == STAGE::CAPTURES || stage_ == STAGE::QUIET_MOVES) && moves_.size() == 1;
+}
+
+const FlatMove* StagedMoveGenerator::nextFromList()
+{
+    while (index_ < moves_.size()) {
+        if (stage_ == STAGE::QUIET_MOVES) {
+            selectBestQuietMove();
+        }
+        const FlatMove& move = moves_[index_++];
+        // the hash move and the killers were already searched
+        if (!wasReturned(move)) {
+            return &move;
+        }
+    }
+    return nullptr;
+}
+
+bool StagedMoveGenerator::wasReturned(const FlatMove& move) const
+{
+    if (hashMoveReturned_ && hashMove_.matches(move)) {
+        return true;
+    }
+    for (size_t i = 0; i < killers_.size(); ++i) {
+        if (killerReturned_[i] && killers_[i].matches(move)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Selection sort one step at a time: after a cutoff the rest of the list is never sorted
+void StagedMoveGenerator::selectBestQuietMove()
+{
+    if (history_ == nullptr) {
+        return;
+    }
+    auto score = [this](const FlatMove& move) {
+        return (*history_)[move.from][move.to()];
+    };
+    size_t best = index_;
+    int32_t bestScore = score(moves_[index_]);
+    for (size_t i = index_ + 1; i < moves_.size(); ++i) {
+        if (const int32_t current = score(moves_[i]); current > bestScore) {
+            best = i;
+            bestScore = current;
+        }
+    }
+    std::swap(moves_[index_], moves_[best]);
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "BoardGeometry.hpp"
+#include "Move.hpp"
+#include "MoveList.hpp"
+
+class Checkers;
+
+// Quiet moves that caused a beta cutoff at the same ply of the search, the most recent first
+using KillerMoves = std::array<PackedMove, 2>;
+// Butterfly table of one side: score of the quiet move `from -> to`, higher is searched earlier
+using HistoryScores = std::array<std::array<int32_t, kMaxSquareCount>, kMaxSquareCount>;
+
+/**
+ * Hands out the moves of a position one by one and generates them only when the search asks for them:
+ * the hash move (checked for legality without generating anything), then the capture sequences and,
+ * only if there are none, the killer moves (checked like the hash move) and the remaining quiet moves
+ * from the highest history score down. After a beta cutoff on an early move the rest is never built.
+ * Capture sequences with the same result are returned once (CAPTURE_PATHS::MERGED).
+ */
+class StagedMoveGenerator {
+public:
+    enum class STAGE {
+        HASH_MOVE = 0,
+        GENERATE_CAPTURES,
+        CAPTURES,
+        KILLER_MOVES,
+        GENERATE_QUIET_MOVES,
+        QUIET_MOVES,
+        DONE,
+    };
+
+private:
+    const Checkers& position_;
+    MoveList& moves_;
+    PackedMove hashMove_;
+    KillerMoves killers_;
+    const HistoryScores* history_;
+    // the quiet hash move once verified, returned before anything is generated
+    FlatMove quietHashMove_;
+    // verified killer moves, indexes match killers_
+    std::array<FlatMove, 2> killerMoves_{};
+    STAGE stage_{STAGE::HASH_MOVE};
+    size_t index_{0};
+    size_t killerIndex_{0};
+    bool hashMoveReturned_{false};
+    std::array<bool, 2> killerReturned_{};
+
+    const FlatMove* nextKiller();
+    const FlatMove* nextFromList();
+    [[nodiscard]] bool wasReturned(const FlatMove& move) const;
+    // moves the quiet move with the highest history score to index_
+    void selectBestQuietMove();
+
+public:
+    // `moves` is scratch storage owned by the caller (one list per ply); `hashMove` and the killers may be
+    //   invalid, `history` may be null (quiet moves keep the generation order then)
+    StagedMoveGenerator(const Checkers& position, MoveList& moves, PackedMove hashMove = {},
+                        const KillerMoves& killers = {}, const HistoryScores* history = nullptr);
+
+    // Next move to search or nullptr when there are no more. The pointer is valid until the next call.
+    const FlatMove* next();
+    [[nodiscard]] STAGE getStage() const;
+    // True when the position is known to have exactly one legal move. Only the generated lists are looked at,
+    //   so a single quiet move returned as the hash or killer move is not recognised
+    [[nodiscard]] bool isSingleReply() const;
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+/**
+ * Random keys for Zobrist hashing: the key of a position is the XOR of one key per (piece, square) plus
+ * `sideToMove` when black is to move, so a move changes it with a few XORs. Every variant gets its own table
+ * (see kZobristKeys in MoveGenerator.hpp), the squares are the ghost square indexes of Board.
+ */
+enum class ZOBRIST_PIECE {
+    WHITE_REGULAR = 0,
+    WHITE_QUEEN,
+    BLACK_REGULAR,
+    BLACK_QUEEN,
+};
+
+template <int SquareCount>
+struct ZobristTable {
+    std::array<std::array<uint64_t, SquareCount>, 4> pieces{};
+    uint64_t sideToMove{0};
+
+    [[nodiscard]] constexpr uint64_t pieceKey(ZOBRIST_PIECE piece, int square) const
+    {
+        return pieces[static_cast<int>(piece)][square];
+    }
+};
+
+// SplitMix64, good enough to fill the tables at compile time
+constexpr uint64_t nextZobristKey(uint64_t& state)
+{
+    state += 0x9E3779B97F4A7C15ULL;
+    uint64_t z = state;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+template <int SquareCount>
+consteval ZobristTable<SquareCount> makeZobristTable(uint64_t seed)
+{
+    ZobristTable<SquareCount> table;
+    for (auto& squares : table.pieces) {
+        for (auto& key : squares) {
+            key = nextZobristKey(seed);
+        }
+    }
+    table.sideToMove = nextZobristKey(seed);
+    return table;
+}
@@ -0,0 +1,149 @@
+#include "AsyncEngine.hpp"
+
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+
+AsyncEngine::AsyncEngine(const Checkers& checkers, const EngineFactory& factory, ASYNC_MODE mode) : mode_{mode}
+{
+    snapshot_.emplace(checkers);
+    engine_ = factory(*snapshot_);
+    if (engine_ == nullptr) {
+        throw std::logic_error("AsyncEngine needs an engine");
+    }
+}
+
+AsyncEngine::~AsyncEngine()
+{
+    cancel();
+}
+
+void AsyncEngine::startSearch(const Checkers& checkers)
+{
+    if (ponderHash_.has_value() && *ponderHash_ == checkers.getHash()) {
+        // ponder hit: the search is already where it should be
+        ponderHash_.reset();
+        engine_->setPondering(false);
+        return;
+    }
+    launch(checkers, false);
+}
+
+bool AsyncEngine::startPondering(const Checkers& checkers)
+{
+    cancel();
+    // nothing would search between the frames
+    if (mode_ == ASYNC_MODE::TIME_SLICED) {
+        return false;
+    }
+    const std::optional<FlatMove> reply = engine_->getPonderMove();
+    if (!reply.has_value()) {
+        return false;
+    }
+    Checkers expected{checkers};
+    expected.makeMoveWithoutHistory(*reply);
+    if (expected.getResult().isOver) {
+        return false;
+    }
+    launch(expected, true);
+    ponderHash_ = expected.getHash();
+    return true;
+}
+
+bool AsyncEngine::isPondering() const
+{
+    return ponderHash_.has_value();
+}
+
+void AsyncEngine::launch(const Checkers& checkers, bool ponder)
+{
+    cancel();
+    // same storage, so the reference held by the engine sees the new position
+    snapshot_.emplace(checkers);
+    engine_->clearStopRequest();
+    engine_->setPondering(ponder);
+    if (mode_ == ASYNC_MODE::TIME_SLICED) {
+        engine_->startSlicedSearch();
+        isSlicedSearchRunning_ = true;
+        return;
+    }
+
+    std::promise<Move> promise;
+    result_ = promise.get_future();
+    thread_ = std::thread([engine = engine_.get(), promise = std::move(promise)]() mutable {
+        try {
+            promise.set_value(engine->getBestMove());
+        } catch (...) {
+            promise.set_exception(std::current_exception());
+        }
+    });
+}
+
+bool AsyncEngine::isSearching() const
+{
+    return result_.valid() || isSlicedSearchRunning_;
+}
+
+std::optional<Move> AsyncEngine::tryGetResult()
+{
+    if (mode_ == ASYNC_MODE::TIME_SLICED) {
+        if (!slicedMove_.has_value()) {
+            return std::nullopt;
+        }
+        isSlicedSearchRunning_ = false;
+        return std::exchange(slicedMove_, std::nullopt);
+    }
+    if (isPondering() || !result_.valid() || result_.wait_for(std::chrono::seconds{0}) != std::future_status::ready) {
+        return std::nullopt;
+    }
+    return waitForResult();
+}
+
+Move AsyncEngine::waitForResult()
+{
+    if (isPondering() || !isSearching()) {
+        throw std::logic_error("AsyncEngine has no search to wait for");
+    }
+    if (mode_ == ASYNC_MODE::TIME_SLICED) {
+        std::optional<Move> move;
+        while (!move.has_value()) {
+            runSlice();
+            move = tryGetResult();
+        }
+        return std::move(*move);
+    }
+    thread_.join();
+    return result_.get();
+}
+
+void AsyncEngine::runSlice()
+{
+    if (mode_ == ASYNC_MODE::TIME_SLICED && isSlicedSearchRunning_ && !slicedMove_.has_value()) {
+        slicedMove_ = engine_->continueSlicedSearch(slice_);
+    }
+}
+
+void AsyncEngine::setSlice(const SearchSlice& slice)
+{
+    slice_ = slice;
+}
+
+void AsyncEngine::stop()
+{
+    engine_->requestStop();
+}
+
+void AsyncEngine::cancel()
+{
+    ponderHash_.reset();
+    // the engine drops the frames of an unfinished sliced search when it starts the next one
+    isSlicedSearchRunning_ = false;
+    slicedMove_.reset();
+    if (!thread_.joinable()) {
+        return;
+    }
+    engine_->requestStop();
+    thread_.join();
+    result_ = {};
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <thread>
+
+#include "Checkers.hpp"
+#include "Engine.hpp"
+#include "Move.hpp"
+
+enum class ASYNC_MODE {
+    THREAD,       // getBestMove() on a thread of its own
+    TIME_SLICED,  // Engine::continueSlicedSearch() on the caller's thread, one slice per runSlice()
+};
+
+/**
+ * Runs the search of an Engine next to the caller (the GUI), so that it keeps going while the engine thinks: on
+ * a thread of its own, or in time slices for builds that cannot use threads. The engine searches a snapshot of
+ * the game taken by startSearch(), never the game itself.
+ *
+ * Pondering: after the engine has moved, startPondering() searches the position after the reply the engine
+ * expects, on the opponent's time. When startSearch() then gets that very position (a ponder hit), the search
+ * goes on and its time limits count from the start of the ponder; any other position cancels it. A time-sliced
+ * engine does not ponder.
+ *
+ * Not thread-safe itself: startSearch(), tryGetResult(), stop() and cancel() are called from one thread.
+ */
+class AsyncEngine {
+public:
+    // Builds the engine on the snapshot it will search; called once, the engine is kept for the whole game
+    using EngineFactory = std::function<std::unique_ptr<Engine>(Checkers&)>;
+
+private:
+    const ASYNC_MODE mode_;
+    // re-created by startSearch() (Checkers can be copied but not assigned); the engine keeps referring to it
+    std::optional<Checkers> snapshot_;
+    std::unique_ptr<Engine> engine_;
+    std::thread thread_;
+    std::future<Move> result_;
+    // the position searched by the ponder, while it is one
+    std::optional<uint64_t> ponderHash_;
+    // TIME_SLICED: a search was started and its move not taken yet, the move once it is done, and how long
+    //   runSlice() may search
+    bool isSlicedSearchRunning_{false};
+    std::optional<Move> slicedMove_;
+    SearchSlice slice_;
+
+    void launch(const Checkers& checkers, bool ponder);
+
+public:
+    AsyncEngine(const Checkers& checkers, const EngineFactory& factory, ASYNC_MODE mode = ASYNC_MODE::THREAD);
+    ~AsyncEngine();
+
+    AsyncEngine(const AsyncEngine&) = delete;
+    AsyncEngine& operator=(const AsyncEngine&) = delete;
+
+    // Starts searching a copy of `checkers`; a search still running is cancelled first, unless it is the ponder of
+    //   this position
+    void startSearch(const Checkers& checkers);
+    // `checkers` is the game after the engine's move. False when the engine expects no reply
+    bool startPondering(const Checkers& checkers);
+    // True from startPondering() until the next startSearch(); there is no result to take meanwhile
+    [[nodiscard]] bool isPondering() const;
+    // True from startSearch() until the result is taken or the search is cancelled
+    [[nodiscard]] bool isSearching() const;
+    // The move once the search is done, nothing while it is still running. Rethrows what the engine threw.
+    //   TIME_SLICED: only takes the move of the slices run so far, it does not search
+    std::optional<Move> tryGetResult();
+    // TIME_SLICED: searches for one slice, the move is kept for tryGetResult(). Does nothing in THREAD mode
+    void runSlice();
+    // TIME_SLICED: the budget of the next slices
+    void setSlice(const SearchSlice& slice);
+    // Blocks until the search is done; TIME_SLICED: runs the slices that are left
+    Move waitForResult();
+    // Asks the search to finish early: the result is the best move found so far and still has to be taken
+    void stop();
+    // Stops the search and throws its result away
+    void cancel();
+};
@@ -1,5 +1,12 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
 #include "Move.hpp"
 
 class Checkers;
@@ -12,9 +19,50 @@ enum class ENGINE_MODE {
     GRANDMASTER
 };
 
+// How long one continueSlicedSearch() may run; the search yields at whichever limit it reaches first
+struct SearchSlice {
+    uint64_t maxNodes{std::numeric_limits<uint64_t>::max()};
+    std::chrono::microseconds maxTime{5000};
+};
+
+// Limits of one search() on top of those the engine was configured with: the tighter one applies. 0 is no limit
+struct SearchLimits {
+    int maxDepth{0};
+    uint64_t maxNodes{0};
+    // no new iteration starts after `softTime`, the running one is abandoned at `hardTime`
+    std::chrono::milliseconds softTime{0};
+    std::chrono::milliseconds hardTime{0};
+};
+
+// A root move with its exact score and the line expected after it
+struct SearchLine {
+    float score{0.0f};
+    std::vector<FlatMove> principalVariation;
+};
+
+// What one search() found and what it took
+struct SearchResult {
+    Move bestMove;
+    // of the best move, from the point of view of the side to move
+    float score{0.0f};
+    // the expected line, starting with the best move
+    std::vector<FlatMove> principalVariation;
+    // of the last completed iteration; 0 when the move was not searched (the only one, or a random one)
+    int depth{0};
+    // positions visited in all threads
+    uint64_t nodes{0};
+    std::chrono::microseconds elapsed{0};
+    // multi-PV analysis only (MinimaxEngine::analyse()): the best moves, best first
+    std::vector<SearchLine> lines;
+};
+
 class Engine {
 protected:
     Checkers& checkers_;
+    // set from another thread to end a running search() early
+    std::atomic<bool> stopRequested_{false};
+    // set while search() runs on the opponent's time, its time limits do not run out then
+    std::atomic<bool> pondering_{false};
 
 public:
     explicit Engine(Checkers& checkers) : checkers_{checkers}
@@ -22,5 +70,49 @@ public:
     }
 
     virtual ~Engine() = default;
-    virtual Move getBestMove() = 0;
+    // Throws std::invalid_argument when the side to move has no legal move (the game is over)
+    virtual SearchResult search(const SearchLimits& limits) = 0;
+
+    // search() with the limits of the engine's configuration only
+    Move getBestMove()
+    {
+        return search(SearchLimits{}).bestMove;
+    }
+
+    // Asks search() to return the best move it has found so far as soon as it can. Thread-safe; the request
+    //   stays until clearStopRequest(), so it also ends a search that had not started yet
+    void requestStop()
+    {
+        stopRequested_.store(true, std::memory_order_relaxed);
+    }
+
+    void clearStopRequest()
+    {
+        stopRequested_.store(false, std::memory_order_relaxed);
+    }
+
+    // Pondering: the search started before the opponent has moved. Thread-safe; when it is switched off (the
+    //   opponent played the expected move) the time limits count from the start of the search
+    void setPondering(bool pondering)
+    {
+        pondering_.store(pondering, std::memory_order_relaxed);
+    }
+
+    // Time-sliced search on the calling thread, for builds that cannot use threads: startSlicedSearch(), then
+    //   continueSlicedSearch() (once per frame) until it returns the move. By default the whole search is one slice.
+    //   Throws like search()
+    virtual void startSlicedSearch()
+    {
+    }
+
+    virtual std::optional<Move> continueSlicedSearch([[maybe_unused]] const SearchSlice& slice)
+    {
+        return getBestMove();
+    }
+
+    // The opponent's reply to the last move returned, if the engine expects one
+    [[nodiscard]] virtual std::optional<FlatMove> getPonderMove() const
+    {
+        return std::nullopt;
+    }
 };
@@ -10,8 +10,8 @@
  *
  * ## Components
  * - `evaluatePosition(const const Board& board)`:
- *   Iterates through the game board, sums the values of white and black pieces including positional modifiers,
- *   and returns the difference as the overall position score.
+ *   Walks the white and black bitboards, sums the precomputed per-square values of the pieces (material plus
+ *   positional modifiers), and returns the difference as the overall position score.
  *
  * ## Usage
  *
@@ -22,13 +22,12 @@
 
 #include <array>
 #include <cassert>
-#include <memory>
 #include <stdexcept>
-#include <vector>
 
+#include "Bitboard.hpp"
 #include "Board.hpp"
+#include "BoardGeometry.hpp"
 #include "Checkers.hpp"
-#include "Piece.hpp"
 
 //////////////
 // EIGHTxEIGHT
@@ -75,18 +74,14 @@ constexpr std::array<float, 6> columnValuesTWELVExTWELVE = {
 };
 // TWELVExTWELVE
 
-static inline float getPieceValue(const Piece p)
+constexpr float getPieceValue(bool isQueen)
 {
-    if (p.isRegular()) {
-        return 3.0f;
-    } else {  // QUEEN
-        return 12.0f;
-    }
+    return isQueen ? 12.0f : 3.0f;
 }
 
-static inline float getRowValue(const BOARD_TYPE bt, const Piece p, int i)
+constexpr float getRowValue(const BOARD_TYPE bt, bool isQueen, int i)
 {
-    if (p.isRegular()) {
+    if (!isQueen) {
         switch (bt) {
             case BOARD_TYPE::EIGHTxEIGHT:
                 assert(i < 8);
@@ -123,7 +118,7 @@ static inline float getRowValue(const BOARD_TYPE bt, const Piece p, int i)
     }
 }
 
-static inline float getColumnValue(const BOARD_TYPE bt, int j)
+constexpr float getColumnValue(const BOARD_TYPE bt, int j)
 {
     switch (bt) {
         case BOARD_TYPE::EIGHTxEIGHT:
@@ -143,27 +138,78 @@ static inline float getColumnValue(const BOARD_TYPE bt, int j)
     }
 }
 
-float evaluatePosition(const Board& board)
-{
-    float whiteSum{0};
-    float blackSum{0};
-
-    const int n = board.getWidth();
-    const BOARD_TYPE bt = board.getBoardType();
-    for (int i = 0; i < n; ++i) {
-        for (int j = (i % 2 ? 0 : 1); j < n; j += 2) {
-            if (auto piece = board(i, j); piece.isNotEmpty()) {
-                if (piece.getColour() == COLOUR::WHITE) {
-                    whiteSum += getPieceValue(piece);
-                    whiteSum += getRowValue(bt, piece, n - 1 - i);
-                    whiteSum += getColumnValue(bt, j);
-                } else {
-                    blackSum += getPieceValue(piece);
-                    blackSum += getRowValue(bt, piece, i);
-                    blackSum += getColumnValue(bt, j);
-                }
-            }
+// Full value (material + row + column) of every piece kind on every square index
+template <BOARD_TYPE BT>
+struct SquareValues {
+    using Geometry = BoardGeometry<BT>;
+
+    std::array<float, Geometry::kSquareCount> whiteRegular{};
+    std::array<float, Geometry::kSquareCount> whiteQueen{};
+    std::array<float, Geometry::kSquareCount> blackRegular{};
+    std::array<float, Geometry::kSquareCount> blackQueen{};
+};
+
+template <BOARD_TYPE BT>
+constexpr SquareValues<BT> kSquareValues = []() consteval {
+    using Geometry = BoardGeometry<BT>;
+    constexpr int n = Geometry::kWidth;
+
+    SquareValues<BT> values;
+    for (int square = 0; square < Geometry::kSquareCount; ++square) {
+        const int i = Geometry::kRowOf[square];
+        const int j = Geometry::kColOf[square];
+        if (i < 0) {
+            continue;  // ghost square
         }
+        values.whiteRegular[square] = getPieceValue(false) + getRowValue(BT, false, n - 1 - i) + getColumnValue(BT, j);
+        values.whiteQueen[square] = getPieceValue(true) + getRowValue(BT, true, n - 1 - i) + getColumnValue(BT, j);
+        values.blackRegular[square] = getPieceValue(false) + getRowValue(BT, false, i) + getColumnValue(BT, j);
+        values.blackQueen[square] = getPieceValue(true) + getRowValue(BT, true, i) + getColumnValue(BT, j);
+    }
+    return values;
+}();
+
+template <typename Mask, size_t N>
+float sumSquareValues(Mask pieces, const std::array<float, N>& values)
+{
+    float sum{0};
+    while (pieces) {
+        sum += values[lowestSquare(pieces)];
+        popLowest(pieces);
     }
+    return sum;
+}
+
+template <BOARD_TYPE BT>
+float evaluateBitboards(const Board& board)
+{
+    using Mask = typename BoardGeometry<BT>::Mask;
+    constexpr const SquareValues<BT>& values = kSquareValues<BT>;
+
+    const Mask white = narrowMask<Mask>(board.getPieces(COLOUR::WHITE));
+    const Mask black = narrowMask<Mask>(board.getPieces(COLOUR::BLACK));
+    const Mask queens = narrowMask<Mask>(board.getQueens());
+
+    const float whiteSum =
+        sumSquareValues(white & ~queens, values.whiteRegular) + sumSquareValues(white & queens, values.whiteQueen);
+    const float blackSum =
+        sumSquareValues(black & ~queens, values.blackRegular) + sumSquareValues(black & queens, values.blackQueen);
     return whiteSum - blackSum;
 }
+
+float evaluatePosition(const Board& board)
+{
+    switch (board.getBoardType()) {
+        case BOARD_TYPE::EIGHTxEIGHT:
+            return evaluateBitboards<BOARD_TYPE::EIGHTxEIGHT>(board);
+
+        case BOARD_TYPE::TENxTEN:
+            return evaluateBitboards<BOARD_TYPE::TENxTEN>(board);
+
+        case BOARD_TYPE::TWELVExTWELVE:
+            return evaluateBitboards<BOARD_TYPE::TWELVExTWELVE>(board);
+
+        default:
+            throw std::logic_error("Unknown BOARD_TYPE in EvaluationFunction");
+    }
+}
@@ -2,167 +2,334 @@
  * Implementation of the MinimaxEngine class using the Minimax algorithm with Alpha-Beta pruning.
  * More about Alpha-Beta pruning: https://www.youtube.com/watch?v=l-hh51ncgDI
  *
- * The MinimaxEngine uses the Minimax algorithm to evaluate possible moves and select the optimal one.
- * It recursively explores potential moves up to a specified depth, alternating between maximizing
- * and minimizing players to simulate both sides' strategies. The evaluation function assesses
- * the desirability of board states, allowing the engine to choose moves that maximize its advantage
- * while minimizing the opponent's.
+ * The search is written as negamax: every score is from the point of view of the side to move, so a child's
+ * score is negated instead of having separate maximizing and minimizing branches.
+ * It is a principal variation search: the first (best ordered) move of a node gets the full window and the
+ * other moves only a null window that proves them worse; a move that fails high is searched again with the
+ * full window. The root searches inside an aspiration window around the score of the previous iteration.
  *
- *
- * isMaximizingPlayer == true - white move
- * isMaximizingPlayer == false - black move
+ * The search itself is in SearchWorker. With `MinimaxConfig::threads` > 1 more workers search the same root on
+ * threads of their own and share the transposition table (Lazy SMP); the main worker's move is played.
+ * With PARALLEL_SEARCH::YOUNG_BROTHERS_WAIT there is only the main worker, and its nodes are split between the
+ * threads of a work-stealing pool instead.
  *
  */
 
 #include "MinimaxEngine.hpp"
 
 #include <algorithm>
-#include <array>
-#include <cmath>
-#include <limits>
-#include <ranges>
+#include <chrono>
 #include <stdexcept>
-#include <unordered_map>
+#include <thread>
 #include <utility>
 #include <vector>
 
+#include "Board.hpp"
 #include "Checkers.hpp"
+#include "SearchWorker.hpp"
+
+MinimaxConfig MinimaxConfig::forMode(ENGINE_MODE mode)
+{
+    using std::chrono::milliseconds;
 
-struct Board;
+    MinimaxConfig config;
+    switch (mode) {
+        case ENGINE_MODE::EASY:
+            config.maxDepth = 2;
+            break;
+        case ENGINE_MODE::MEDIUM:
+            config.maxDepth = 4;
+            break;
+        case ENGINE_MODE::HARD:
+            // depth limited, the time limit only caps the latency in big positions
+            config.maxDepth = 6;
+            config.softTime = milliseconds{1000};
+            config.hardTime = milliseconds{2000};
+            break;
+        case ENGINE_MODE::GRANDMASTER:
+            // time limited: as deep as the time allows
+            config.maxDepth = kMaxSearchDepth;
+            config.softTime = milliseconds{1000};
+            config.hardTime = milliseconds{3000};
+            break;
+        default:
+            // NO NOVICE HERE AND THIS IS CORRECT
+            throw std::logic_error("MinimaxEngine doesn't implement NOVICE mode. Use Random Engine instead");
+    }
+    return config;
+}
 
-constexpr std::array<int, 4> maxDepthsArr = []() consteval {
-    std::array<int, 4> arr = {};
-    // NO NOVICE HERE AND THIS IS CORRECT
-    arr[static_cast<int>(ENGINE_MODE::EASY)] = 2;
-    arr[static_cast<int>(ENGINE_MODE::MEDIUM)] = 4;
-    arr[static_cast<int>(ENGINE_MODE::HARD)] = 6;
-    arr[static_cast<int>(ENGINE_MODE::GRANDMASTER)] = 8;
-    return arr;
-}();
+static std::chrono::microseconds elapsedSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+}
 
-static inline int engineModeToInt(ENGINE_MODE mode)
+// The tighter of two limits where 0 is no limit
+template <typename T>
+static T tighterLimit(T configured, T requested)
 {
-    return static_cast<int>(mode);
+    if (configured == T{0}) {
+        return requested;
+    }
+    if (requested == T{0}) {
+        return configured;
+    }
+    return std::min(configured, requested);
 }
 
-float evaluatePosition(const Board& board);
+// `firstMove` followed by the rest of `line`. The line only keeps the identity of its moves, the full moves are
+//   found again by replaying it; a line that does not start with `firstMove` is not replayed
+static std::vector<FlatMove> resolveLine(const Checkers& checkers, const FlatMove& firstMove,
+                                         const SearchWorker::PrincipalVariation& line, MoveList& moves)
+{
+    std::vector<FlatMove> resolved{firstMove};
+    if (line.length == 0 || !line.moves[0].matches(firstMove)) {
+        return resolved;
+    }
+    Checkers position = checkers;
+    MoveUndo firstUndo;
+    position.doMove(firstMove, firstUndo);
+    for (int i = 1; i < line.length; ++i) {
+        position.generateMoves(moves, CAPTURE_PATHS::MERGED);
+        const auto it = std::find_if(moves.begin(), moves.end(), [&line, i](const FlatMove& move) {
+            return line.moves[static_cast<size_t>(i)].matches(move);
+        });
+        if (it == moves.end()) {
+            break;
+        }
+        resolved.push_back(*it);
+        MoveUndo undo;
+        position.doMove(*it, undo);
+    }
+    return resolved;
+}
+
+static const MinimaxConfig& validated(const MinimaxConfig& config)
+{
+    if (config.maxDepth < 1 || config.maxDepth > kMaxSearchDepth) {
+        throw std::logic_error("MinimaxConfig::maxDepth is out of range");
+    }
+    if (config.threads < 1) {
+        throw std::logic_error("MinimaxConfig::threads must be at least 1");
+    }
+    if (config.minSplitDepth < 2) {
+        throw std::logic_error("MinimaxConfig::minSplitDepth must be at least 2");
+    }
+    return config;
+}
 
 MinimaxEngine::MinimaxEngine(Checkers& checkers, ENGINE_MODE mode) :
-    Engine(checkers),
-    maxDepth_{mode == ENGINE_MODE::NOVICE
-                  ? throw std::logic_error("MinimaxEngine doesn't implement NOVICE mode. Use Random Engine instead")
-                  : maxDepthsArr[engineModeToInt(mode)]}
+    MinimaxEngine(checkers, MinimaxConfig::forMode(mode))
 {
 }
 
-static inline float getDefaultScore(bool isMaximizingPlayer)
+MinimaxEngine::MinimaxEngine(Checkers& checkers, const MinimaxConfig& config) :
+    Engine(checkers),
+    config_{validated(config)},
+    tt_{config_.transpositionTableMb},
+    control_{std::make_unique<SearchControl>()}
 {
-    if (isMaximizingPlayer) {
-        return std::numeric_limits<float>::lowest();
-    } else {
-        return std::numeric_limits<float>::max();
+    control_->stopRequested = &stopRequested_;
+    control_->pondering = &pondering_;
+    if (config_.parallelSearch == PARALLEL_SEARCH::YOUNG_BROTHERS_WAIT && config_.threads > 1) {
+        // the calling thread searches too, it helps with the young brothers while it waits for them
+        splitWorkers_ = std::make_unique<SplitWorkers>(config_, tt_, config_.threads - 1);
+        workers_.push_back(std::make_unique<SearchWorker>(config_, tt_, 0, splitWorkers_.get()));
+        return;
+    }
+    for (int i = 0; i < config_.threads; ++i) {
+        workers_.push_back(std::make_unique<SearchWorker>(config_, tt_, i));
     }
 }
 
-// Recursive Minimax function
-float MinimaxEngine::EvaluatePositionRecursive(int depth, const Checkers& curBoard, bool isMaximizingPlayer, float alpha,
-                                               float beta)
+MinimaxEngine::~MinimaxEngine() = default;
+
+// Generates the root moves and sets the workers up. Returns the result right away when there is only one move
+std::optional<SearchResult> MinimaxEngine::prepareSearch(const SearchLimits& limits, int lineCount)
 {
-    if (auto result = curBoard.getResult(); result.isOver) {
-        if (result.winner == COLOUR::WHITE) {
-            return 1000.0f;
-        } else {
-            return -1000.0f;
-        }
+    if (limits.maxDepth < 0 || limits.maxDepth > kMaxSearchDepth) {
+        throw std::logic_error("SearchLimits::maxDepth is out of range");
     }
-    if (depth >= maxDepth_) {
-        return evaluatePosition(curBoard.getBoard());
+    control_->start = std::chrono::steady_clock::now();
+    tt_.newSearch();
+    // Capture orders with the same outcome are searched once; any of them is a valid answer for the GUI
+    checkers_.generateMoves(rootMoveList_, CAPTURE_PATHS::MERGED);
+    if (rootMoveList_.empty()) {
+        throw std::invalid_argument("MinimaxEngine cannot search a position without legal moves");
     }
 
-    const auto& moves = curBoard.getValidMoves();
-    if (moves.empty()) {
-        return evaluatePosition(curBoard.getBoard());
+    // Doesn't do anything if there is only one possible move, unless its score is wanted
+    if (rootMoveList_.size() == 1 && lineCount == 0) {
+        principalVariation_.assign(1, rootMoveList_[0]);
+        SearchResult result;
+        result.bestMove = toChainMove(rootMoveList_[0], checkers_.getBoard().getBoardType());
+        result.principalVariation = principalVariation_;
+        result.elapsed = elapsedSince(control_->start);
+        return result;
     }
 
-    // Initialize bestScore based on whether we're maximizing or minimizing
-    float bestScore = getDefaultScore(isMaximizingPlayer);
+    // Simulate random decision-making if the moves are approximately equal in strength
+    // This is to minimize the probability of completely identical games by making the same moves.
+    //   An analysis wants the scores as they are
+    std::vector<SearchWorker::RootMove> rootMoves;
+    rootMoves.reserve(rootMoveList_.size());
+    for (const auto& move : rootMoveList_) {
+        SearchWorker::RootMove& root = rootMoves.emplace_back();
+        root.move = move;
+        root.noise = lineCount == 0 ? dist(mt) : 0.0f;
+    }
 
-    for (const auto& val : moves | std::views::values) {
-        for (const auto& move : val) {
-            // Clone the current board to simulate the move
-            Checkers newBoard = curBoard;
-            newBoard.makeMoveWithoutHistory(move);
+    // Every worker searches its own copy of the position, so the game state is never touched
+    control_->maxDepth = tighterLimit(config_.maxDepth, limits.maxDepth);
+    control_->maxNodes = limits.maxNodes;
+    control_->softTime = tighterLimit(config_.softTime, limits.softTime);
+    control_->hardTime = tighterLimit(config_.hardTime, limits.hardTime);
+    control_->lineCount = lineCount;
+    control_->nodes.store(0, std::memory_order_relaxed);
+    control_->stop.store(false, std::memory_order_relaxed);
+    for (auto& worker : workers_) {
+        worker->startSearch(checkers_, rootMoves, *control_);
+    }
+    if (splitWorkers_ != nullptr) {
+        for (const auto& worker : splitWorkers_->getWorkers()) {
+            worker->resetCounters();
+        }
+    }
+    return std::nullopt;
+}
 
-            // Recursively evaluate the new board state
-            float currentScore = EvaluatePositionRecursive(depth + 1, newBoard, !isMaximizingPlayer, alpha, beta);
+// The move of the main worker, and its line
+SearchResult MinimaxEngine::finishSearch()
+{
+    const SearchWorker& mainWorker = *workers_.front();
+    const SearchWorker::IterationResult& iteration = mainWorker.getResult();
+    // the move played, even if the table has no line for it
+    principalVariation_ = resolveLine(checkers_, iteration.bestMove, iteration.line, rootMoveList_);
 
-            // Update bestScore based on maximizing or minimizing
-            if (isMaximizingPlayer) {
-                bestScore = std::max(bestScore, currentScore);
-                alpha = std::max(alpha, bestScore);
-            } else {
-                bestScore = std::min(bestScore, currentScore);
-                beta = std::min(beta, bestScore);
-            }
-            if (beta <= alpha) {
-                break;
-            }
-        }
-        if (beta <= alpha) {
-            break;
-        }
+    SearchResult result;
+    result.bestMove = toChainMove(iteration.bestMove, checkers_.getBoard().getBoardType());
+    // the random noise of the move is a part of it
+    result.score = iteration.score;
+    result.principalVariation = principalVariation_;
+    result.depth = iteration.depth;
+    result.nodes = getNodeCount();
+    for (const SearchWorker::RootLine& line : iteration.lines) {
+        result.lines.push_back(SearchLine{line.score, resolveLine(checkers_, line.move, line.line, rootMoveList_)});
     }
+    result.elapsed = elapsedSince(control_->start);
+    return result;
+}
 
-    return bestScore;
+SearchResult MinimaxEngine::search(const SearchLimits& limits)
+{
+    return runSearch(limits, 0);
 }
 
-Move MinimaxEngine::getBestMove()
+SearchResult MinimaxEngine::analyse(const SearchLimits& limits, int lineCount)
 {
-    // Doesn't do anything if there is only one possible move
-    const auto& moves = checkers_.getValidMoves();
-    if (moves.size() == 1 && moves.begin()->second.size() == 1) {
-        return cloneMove(moves.begin()->second[0]);
+    if (lineCount < 1) {
+        throw std::logic_error("MinimaxEngine::analyse() needs at least one line");
     }
+    return runSearch(limits, lineCount);
+}
 
-    // Determine if the current player is maximizing or minimizing
-    bool isMaximizingPlayer = checkers_.getCurrentColour() == COLOUR::WHITE;
-    float bestScore = getDefaultScore(isMaximizingPlayer);
-
-    Move bestMove;
+SearchResult MinimaxEngine::runSearch(const SearchLimits& limits, int lineCount)
+{
+    if (std::optional<SearchResult> onlyMove = prepareSearch(limits, lineCount)) {
+        return std::move(*onlyMove);
+    }
 
-    for (const auto& val : moves | std::views::values) {
-        for (const auto& move : val) {
-            // Clone the current board to simulate the move
-            Checkers newBoard = checkers_;
-            newBoard.makeMoveWithoutHistory(move);
+    std::vector<std::thread> helpers;
+    helpers.reserve(workers_.size() - 1);
+    for (size_t i = 1; i < workers_.size(); ++i) {
+        helpers.emplace_back([worker = workers_[i].get()]() {
+            worker->run();
+        });
+    }
+    workers_.front()->run();
+    control_->stop.store(true, std::memory_order_relaxed);
+    for (auto& helper : helpers) {
+        helper.join();
+    }
+    return finishSearch();
+}
 
-            // Evaluate the move using the recursive function
-            float alpha = getDefaultScore(true);
-            float beta = getDefaultScore(false);
-            float currentScore = EvaluatePositionRecursive(1, newBoard, !isMaximizingPlayer, alpha, beta);
+// Only the main worker searches, on the calling thread. The time limits are wall time: the frames drawn between
+//   the slices count too
+void MinimaxEngine::startSlicedSearch()
+{
+    slicedResult_.reset();
+    if (std::optional<SearchResult> onlyMove = prepareSearch(SearchLimits{}, 0)) {
+        slicedResult_ = std::move(onlyMove->bestMove);
+    } else {
+        workers_.front()->startSlicedSearch();
+    }
+}
 
-            // Simulate random decision-making if the moves are approximately equal in strength
-            // This is to minimize the probability of completely identical games by making the same moves
-            if (std::abs(currentScore - bestScore) < 0.5f) {
-                currentScore += dist(mt);
-            }
+std::optional<Move> MinimaxEngine::continueSlicedSearch(const SearchSlice& slice)
+{
+    if (!slicedResult_.has_value()) {
+        if (!workers_.front()->resumeSlice(slice)) {
+            return std::nullopt;
+        }
+        slicedResult_ = finishSearch().bestMove;
+    }
+    return std::exchange(slicedResult_, std::nullopt);
+}
 
-            // Update the bestMove if a better score is found
-            if (isMaximizingPlayer) {
-                if (currentScore > bestScore) {
-                    bestScore = currentScore;
-                    bestMove = cloneMove(move);
-                }
-                alpha = std::max(alpha, bestScore);
-            } else {
-                if (currentScore < bestScore) {
-                    bestScore = currentScore;
-                    bestMove = cloneMove(move);
-                }
-                beta = std::min(beta, bestScore);
-            }
+std::vector<const SearchWorker*> MinimaxEngine::getAllWorkers() const
+{
+    std::vector<const SearchWorker*> workers;
+    for (const auto& worker : workers_) {
+        workers.push_back(worker.get());
+    }
+    if (splitWorkers_ != nullptr) {
+        for (const auto& worker : splitWorkers_->getWorkers()) {
+            workers.push_back(worker.get());
         }
     }
+    return workers;
+}
+
+const std::vector<FlatMove>& MinimaxEngine::getPrincipalVariation() const
+{
+    return principalVariation_;
+}
+
+std::optional<FlatMove> MinimaxEngine::getPonderMove() const
+{
+    if (principalVariation_.size() < 2) {
+        return std::nullopt;
+    }
+    return principalVariation_[1];
+}
 
-    return bestMove;
+uint64_t MinimaxEngine::getNodeCount() const
+{
+    uint64_t nodes = 0;
+    for (const SearchWorker* worker : getAllWorkers()) {
+        nodes += worker->getNodeCount();
+    }
+    return nodes;
+}
+
+uint64_t MinimaxEngine::getQuiescenceNodeCount() const
+{
+    uint64_t nodes = 0;
+    for (const SearchWorker* worker : getAllWorkers()) {
+        nodes += worker->getQuiescenceNodeCount();
+    }
+    return nodes;
+}
+
+SelectivityStats MinimaxEngine::getSelectivityStats() const
+{
+    SelectivityStats stats;
+    for (const SearchWorker* worker : getAllWorkers()) {
+        const SelectivityStats workerStats = worker->getSelectivityStats();
+        stats.extensions += workerStats.extensions;
+        stats.reductions += workerStats.reductions;
+        stats.reductionResearches += workerStats.reductionResearches;
+    }
+    return stats;
 }
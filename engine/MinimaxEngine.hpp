@@ -1,20 +1,115 @@
 #pragma once
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
 #include <random>
+#include <vector>
 
 #include "Engine.hpp"
 #include "Move.hpp"
+#include "MoveList.hpp"
+#include "TranspositionTable.hpp"
 class Checkers;
+class SearchWorker;
+class SplitWorkers;
+struct SearchControl;
+
+// Deepest iteration of the search; the transposition table keeps depths up to 127
+inline constexpr int kMaxSearchDepth = 64;
+// Plies a line may be extended beyond the iteration depth
+inline constexpr int kMaxSearchExtension = 16;
+
+// How the threads of MinimaxConfig::threads share the search
+enum class PARALLEL_SEARCH {
+    LAZY_SMP,             // every thread searches the whole tree, they share the transposition table
+    YOUNG_BROTHERS_WAIT,  // one search whose nodes are split between the threads after their first move
+};
+
+/**
+ * Limits of every search() call; the SearchLimits of a call may tighten them. The search deepens one ply at a
+ * time up to `maxDepth`. With a time limit no new iteration starts after `softTime` (stretched while the best move
+ * keeps changing), and the current iteration is abandoned at `hardTime` in favour of the best move of the last
+ * completed one. A zero time means no time limit.
+ */
+struct MinimaxConfig {
+    int maxDepth{kMaxSearchDepth};
+    std::chrono::milliseconds softTime{0};
+    std::chrono::milliseconds hardTime{0};
+    size_t transpositionTableMb{16};
+
+    // Late move reductions: from the `lateMoveReductionFirstMove`-th move of a node with at least
+    //   `lateMoveReductionMinDepth` plies left, quiet moves are first searched `lateMoveReduction` plies shallower.
+    //   0 turns them off
+    int lateMoveReduction{1};
+    int lateMoveReductionMinDepth{3};
+    int lateMoveReductionFirstMove{3};
+    // Plies added when the side to move has a single legal move. 0 turns it off
+    int singleReplyExtension{1};
+
+    // Search threads. 1 searches on the calling thread only
+    int threads{1};
+    PARALLEL_SEARCH parallelSearch{PARALLEL_SEARCH::LAZY_SMP};
+    // YOUNG_BROTHERS_WAIT: nodes with fewer plies left are not split
+    int minSplitDepth{4};
+
+    // Depth limits for the easy levels, time limits for the hard ones. Throws for NOVICE
+    static MinimaxConfig forMode(ENGINE_MODE mode);
+};
+
+// How often the last search() searched selectively
+struct SelectivityStats {
+    uint64_t extensions{0};           // nodes whose single reply was extended
+    uint64_t reductions{0};           // moves searched with a reduced depth
+    uint64_t reductionResearches{0};  // reduced moves that beat alpha and were searched again
+};
 
 class MinimaxEngine final : public Engine {
 private:
-    const int maxDepth_;
+    const MinimaxConfig config_;
     std::mt19937 mt{std::random_device{}()};
     std::uniform_real_distribution<float> dist{-0.3f, 0.3f};
+    // lives as long as the engine, so results are reused between the moves of one game; shared by the threads
+    TranspositionTable tt_;
+    // shared by the workers of one search
+    std::unique_ptr<SearchControl> control_;
+    // workers_[0] searches on the calling thread, the others on threads of their own (Lazy SMP only)
+    std::vector<std::unique_ptr<SearchWorker>> workers_;
+    // YOUNG_BROTHERS_WAIT: the pool threads besides the calling one and their workers
+    std::unique_ptr<SplitWorkers> splitWorkers_;
+    MoveList rootMoveList_;
+    // the line of the last completed iteration, starting with the returned move
+    std::vector<FlatMove> principalVariation_;
+    // the move of a time-sliced search that is done, until continueSlicedSearch() hands it out
+    std::optional<Move> slicedResult_;
 
-    float EvaluatePositionRecursive(int depth, const Checkers& curBoard, bool isMaximizingPlayer, float alpha, float beta);
+    // `lineCount` is 0 for search(), which plays the move
+    std::optional<SearchResult> prepareSearch(const SearchLimits& limits, int lineCount);
+    SearchResult finishSearch();
+    SearchResult runSearch(const SearchLimits& limits, int lineCount);
+    [[nodiscard]] std::vector<const SearchWorker*> getAllWorkers() const;
 
 public:
     MinimaxEngine(Checkers& checkers, ENGINE_MODE mode);
-    Move getBestMove() override;
+    MinimaxEngine(Checkers& checkers, const MinimaxConfig& config);
+    ~MinimaxEngine() override;
+    SearchResult search(const SearchLimits& limits) override;
+    // Multi-PV: search() that also returns the `lineCount` best root moves (fewer if there are not as many) with
+    //   their exact scores in SearchResult::lines. There is no random noise in the scores. Throws for
+    //   `lineCount` < 1
+    SearchResult analyse(const SearchLimits& limits, int lineCount);
+    void startSlicedSearch() override;
+    std::optional<Move> continueSlicedSearch(const SearchSlice& slice) override;
+
+    // Expected line of the last search(): the returned move, the reply and so on
+    [[nodiscard]] const std::vector<FlatMove>& getPrincipalVariation() const;
+    // The second move of the principal variation
+    [[nodiscard]] std::optional<FlatMove> getPonderMove() const override;
+    // Positions visited by the last search() in all threads, the quiescence search included
+    [[nodiscard]] uint64_t getNodeCount() const;
+    // The part of getNodeCount() visited by the quiescence search, from the horizon on
+    [[nodiscard]] uint64_t getQuiescenceNodeCount() const;
+    [[nodiscard]] SelectivityStats getSelectivityStats() const;
 };
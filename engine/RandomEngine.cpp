@@ -1,28 +1,27 @@
 #include "RandomEngine.hpp"
 
-#include <ranges>
+#include <chrono>
 #include <stdexcept>
-#include <unordered_map>
-#include <vector>
 
+#include "Board.hpp"
 #include "Checkers.hpp"
 
 RandomEngine::RandomEngine(Checkers& checkers) : Engine(checkers)
 {
 }
 
-Move RandomEngine::getBestMove()
+SearchResult RandomEngine::search([[maybe_unused]] const SearchLimits& limits)
 {
+    const auto start = std::chrono::steady_clock::now();
     const auto& validMoves = checkers_.getValidMoves();
     if (const auto size = validMoves.size(); size > 0) {
-        const auto moveIndex = mt() % size;
-        int i = 0;
-        for (const auto& moves : validMoves | std::views::values) {
-            if (i == static_cast<int>(moveIndex)) {
-                return cloneMove(moves[mt() % moves.size()]);
-            }
-            ++i;
-        }
+        const FlatMove& move = validMoves[mt() % size];
+        SearchResult result;
+        result.bestMove = toChainMove(move, checkers_.getBoard().getBoardType());
+        result.principalVariation.push_back(move);
+        result.elapsed =
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        return result;
     }
-    throw std::runtime_error("Engine cannot produce the valid move");
+    throw std::invalid_argument("Engine cannot produce the valid move");
 }
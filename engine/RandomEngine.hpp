@@ -13,5 +13,6 @@ private:
 
 public:
     explicit RandomEngine(Checkers& checkers);
-    Move getBestMove() override;
+    // Picks a move at once, `limits` do not matter
+    SearchResult search(const SearchLimits& limits) override;
 };
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+/**
+ * Coroutine returning a T, for the time-sliced search. It starts suspended and runs when it is awaited (or
+ * resumed by its owner); when it finishes it continues the coroutine that awaited it (symmetric transfer, so a
+ * deep line of awaits does not grow the stack). A coroutine in the chain that suspends otherwise (SearchWorker
+ * yielding at the end of a slice) returns to whoever resumed the chain last.
+ */
+template <typename T>
+class SearchTask {
+public:
+    struct promise_type;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    struct promise_type {
+        T value{};
+        std::coroutine_handle<> continuation{std::noop_coroutine()};
+
+        SearchTask get_return_object()
+        {
+            return SearchTask{Handle::from_promise(*this)};
+        }
+
+        std::suspend_always initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        auto final_suspend() noexcept
+        {
+            struct ContinueAwaiter {
+                bool await_ready() noexcept
+                {
+                    return false;
+                }
+
+                std::coroutine_handle<> await_suspend(Handle finished) noexcept
+                {
+                    return finished.promise().continuation;
+                }
+
+                void await_resume() noexcept
+                {
+                }
+            };
+            return ContinueAwaiter{};
+        }
+
+        void return_value(T result)
+        {
+            value = std::move(result);
+        }
+
+        // the search does not throw
+        void unhandled_exception()
+        {
+            std::terminate();
+        }
+    };
+
+private:
+    Handle handle_;
+
+    explicit SearchTask(Handle handle) : handle_{handle}
+    {
+    }
+
+public:
+    SearchTask(SearchTask&& other) noexcept : handle_{std::exchange(other.handle_, {})}
+    {
+    }
+
+    SearchTask& operator=(SearchTask&& other) noexcept
+    {
+        if (this != &other) {
+            if (handle_) {
+                handle_.destroy();
+            }
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+
+    // Destroys a suspended chain from the top: every frame owns the task it awaits
+    ~SearchTask()
+    {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+    {
+        handle_.promise().continuation = awaiting;
+        return handle_;
+    }
+
+    T await_resume()
+    {
+        return std::move(handle_.promise().value);
+    }
+
+    [[nodiscard]] Handle getHandle() const
+    {
+        return handle_;
+    }
+
+    [[nodiscard]] bool isDone() const
+    {
+        return handle_.done();
+    }
+
+    [[nodiscard]] const T& getResult() const
+    {
+        return handle_.promise().value;
+    }
+};
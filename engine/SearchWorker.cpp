@@ -0,0 +1,948 @@
+/**
+ * The search of one thread of MinimaxEngine (see MinimaxEngine.cpp for the algorithm).
+ *
+ * Lazy SMP: every thread runs the whole iterative deepening on its own copy of the position with its own move
+ * lists, killers and history; the only thing they share is the transposition table. The helpers start their
+ * iterations at staggered depths, so they fill the table with results the main thread needs next and it
+ * finds them instead of searching. The main thread keeps the time and its result is the one played.
+ *
+ * Young Brothers Wait (MinimaxConfig::parallelSearch): there is one iterative deepening, and its nodes are split
+ * instead. The first move of a node is searched alone, because it usually decides whether the others are needed
+ * at all and gives the alpha to search them with. Then all the remaining moves ("young brothers") go to the
+ * work-stealing pool and are searched in parallel with the null window of that alpha, each by a spare worker.
+ * A brother that fails high ends the node and cancels the ones still running; otherwise the node goes through
+ * their scores in move order as if it had searched them itself. Only nodes with minSplitDepth plies left split,
+ * below that the tasks would cost more than they bring.
+ *
+ * Time slicing (startSlicedSearch()): for builds without threads the iterative deepening, the root and the nodes
+ * above kSliceHorizon are C++20 coroutines (searchNode()) that suspend between moves once the slice of
+ * resumeSlice() is used up, and continue from there with the next one. run() is the same coroutine resumed once.
+ */
+
+#include "SearchWorker.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+
+#include "Board.hpp"
+
+float evaluatePosition(const Board& board);
+
+namespace
+{
+// The side to move without moves loses
+constexpr float kNoMovesScore = -1000.0f;
+// kNoMovesScore minus the random noise of the root
+constexpr float kDecisiveScore = 999.0f;
+constexpr float kInfinity = std::numeric_limits<float>::max();
+// width of the window that only asks "is this move better than alpha?"
+constexpr float kNullWindow = 0.001f;
+// The root window is the previous score +- kAspirationWindow (a third of a man) from kAspirationMinDepth on.
+//   It doubles after every fail and becomes the full window past kMaxAspirationWindow
+constexpr float kAspirationWindow = 1.0f;
+constexpr float kMaxAspirationWindow = 16.0f;
+constexpr int kAspirationMinDepth = 3;
+// the soft limit grows this much for every iteration that changes the best move, up to kMaxSoftTimeScale
+constexpr double kUnstableTimeFactor = 1.5;
+constexpr double kStableTimeFactor = 0.9;
+constexpr double kMaxSoftTimeScale = 2.5;
+// no new iteration starts after this share of the soft limit
+constexpr double kNextIterationShare = 0.5;
+// history scores are halved before they get near the int32_t limit
+constexpr int32_t kMaxHistoryScore = 1 << 24;
+// Captures the quiescence search resolves in a row at most; a longer exchange is evaluated as it stands
+constexpr int kMaxQuiescenceDepth = 16;
+// Time-sliced search: nodes with this many plies left or fewer are searched without suspending
+constexpr int kSliceHorizon = 2;
+// checking the clock on every node would be measurable
+constexpr uint64_t kNodesBetweenTimeChecks = 1024 - 1;
+
+// Depths skipped by the helper threads: helper i searches only the depths where
+//   ((depth + kSkipPhase[i]) / kSkipSize[i]) is even, so the helpers spread over the next iterations
+constexpr std::array<int, 20> kSkipSize{1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4};
+constexpr std::array<int, 20> kSkipPhase{0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7};
+
+// evaluatePosition() is from white's point of view
+float evaluateForSideToMove(const Checkers& position)
+{
+    const float score = evaluatePosition(position.getBoard());
+    return position.getCurrentColour() == COLOUR::WHITE ? score : -score;
+}
+}  // namespace
+
+struct SearchWorker::NodeWindow {
+    NodeWindow(float alpha, float beta) : alpha{alpha}, beta{beta}, originalAlpha{alpha}
+    {
+    }
+
+    float alpha;
+    const float beta;
+    const float originalAlpha;
+    float bestScore{-kInfinity};
+    PackedMove bestMove;
+};
+
+struct SearchWorker::ChildSearch {
+    int depth;
+    // from the point of view of the child
+    float alpha;
+    float beta;
+};
+
+// The child searches of one move of a node. The first move gets the full window. A later one gets a null window
+//   that only proves it worse than alpha: first with the depth reduced by lateMoveReductionOf(), again with the full
+//   depth if it beats alpha anyway, and at last the full window if its score lands between alpha and beta.
+//   EvaluatePositionRecursive() and searchNode() both run these steps, each with its own child search, so the
+//   time-sliced search visits the same tree as the threaded one
+class SearchWorker::MoveSearch {
+public:
+    // `nullWindowOnly`: the young brothers of a split stop before the full window, the node itself decides on it
+    MoveSearch(SearchWorker& worker, int depth, int childDepth, int moveNumber, const FlatMove& move,
+               const Checkers& position, float alpha, float beta, bool nullWindowOnly = false) :
+        worker_{worker},
+        childDepth_{childDepth},
+        moveNumber_{moveNumber},
+        reduction_{moveNumber > 0 ? worker.lateMoveReductionOf(depth, childDepth, moveNumber, move, position) : 0},
+        alpha_{alpha},
+        beta_{beta},
+        nullWindowOnly_{nullWindowOnly}
+    {
+    }
+
+    [[nodiscard]] ChildSearch first()
+    {
+        if (moveNumber_ == 0) {
+            step_ = STEP::FULL_WINDOW;
+            return fullWindow();
+        }
+        if (reduction_ > 0) {
+            ++worker_.reductions_;
+        }
+        step_ = STEP::REDUCED;
+        return nullWindow(childDepth_ - reduction_);
+    }
+
+    // The search after the one that gave `score` (from the point of view of the node); nothing when `score` is the
+    //   score of the move
+    [[nodiscard]] std::optional<ChildSearch> next(float score)
+    {
+        if (step_ == STEP::FULL_WINDOW) {
+            return std::nullopt;
+        }
+        if (step_ == STEP::REDUCED && reduction_ > 0 && score > alpha_) {
+            ++worker_.reductionResearches_;
+            step_ = STEP::NULL_WINDOW;
+            return nullWindow(childDepth_);
+        }
+        return afterNullWindow(score);
+    }
+
+    // `score` stands for the null window searches (YBWC: the move was searched as a young brother)
+    [[nodiscard]] std::optional<ChildSearch> afterNullWindow(float score)
+    {
+        if (nullWindowOnly_ || score <= alpha_ || score >= beta_) {
+            return std::nullopt;
+        }
+        step_ = STEP::FULL_WINDOW;
+        return fullWindow();
+    }
+
+private:
+    enum class STEP {
+        REDUCED,
+        NULL_WINDOW,
+        FULL_WINDOW,
+    };
+
+    SearchWorker& worker_;
+    const int childDepth_;
+    const int moveNumber_;
+    const int reduction_;
+    const float alpha_;
+    const float beta_;
+    const bool nullWindowOnly_;
+    STEP step_{STEP::REDUCED};
+
+    [[nodiscard]] ChildSearch fullWindow() const
+    {
+        return ChildSearch{childDepth_, -beta_, -alpha_};
+    }
+
+    [[nodiscard]] ChildSearch nullWindow(int depth) const
+    {
+        return ChildSearch{depth, -alpha_ - kNullWindow, -alpha_};
+    }
+};
+
+struct SearchWorker::SliceYield {
+    SearchWorker& worker;
+
+    [[nodiscard]] bool await_ready() const
+    {
+        return !worker.isSliceUsedUp();
+    }
+
+    // back to resumeSlice(), which resumes `suspended` with the next slice
+    void await_suspend(std::coroutine_handle<> suspended)
+    {
+        worker.slice_->suspended = suspended;
+    }
+
+    void await_resume()
+    {
+    }
+};
+
+SearchWorker::SearchWorker(const MinimaxConfig& config, TranspositionTable& tt, int index,
+                           SplitWorkers* splitWorkers) :
+    config_{config},
+    tt_{tt},
+    index_{index},
+    maxPly_{config_.maxDepth + kMaxSearchExtension},
+    splitWorkers_{splitWorkers},
+    plyMoves_(static_cast<size_t>(maxPly_ + 1 + kMaxQuiescenceDepth)),
+    killers_(static_cast<size_t>(maxPly_) + 1),
+    pv_(static_cast<size_t>(maxPly_) + 1)
+{
+}
+
+void SearchWorker::startSearch(const Checkers& position, const std::vector<RootMove>& rootMoves,
+                               SearchControl& control)
+{
+    position_.emplace(position, CHECKERS_COPY::SEARCH);
+    rootMoves_ = rootMoves;
+    control_ = &control;
+    // killers belong to the plies of the previous position, the history still says something about this one
+    std::fill(killers_.begin(), killers_.end(), KillerMoves{});
+    ageHistory();
+
+    result_ = IterationResult{};
+    result_.bestMove = rootMoves_.front().move;
+    stopped_ = false;
+    resetCounters();
+    // drops a time-sliced search that did not finish, with all its frames
+    slicedTask_.reset();
+    slice_.reset();
+}
+
+void SearchWorker::startSlicedSearch()
+{
+    slice_.emplace();
+    slicedTask_.emplace(iterate());
+    slice_->suspended = slicedTask_->getHandle();
+}
+
+bool SearchWorker::resumeSlice(const SearchSlice& slice)
+{
+    if (!slicedTask_.has_value()) {
+        throw std::logic_error("SearchWorker::resumeSlice() without startSlicedSearch()");
+    }
+    if (!slicedTask_->isDone()) {
+        slice_->budget = slice;
+        slice_->startNodes = nodes_ + quiescenceNodes_;
+        slice_->start = std::chrono::steady_clock::now();
+        // returns when the search yields or is done
+        slice_->suspended.resume();
+    }
+    return slicedTask_->isDone();
+}
+
+bool SearchWorker::isSliceUsedUp() const
+{
+    if (!slice_.has_value()) {
+        return false;
+    }
+    return nodes_ + quiescenceNodes_ - slice_->startNodes >= slice_->budget.maxNodes
+           || std::chrono::steady_clock::now() - slice_->start >= slice_->budget.maxTime;
+}
+
+SearchWorker::SliceYield SearchWorker::yieldIfSliceUsedUp()
+{
+    return SliceYield{*this};
+}
+
+void SearchWorker::startSplitTask(const SearchWorker& parent, const Checkers& position, const SplitPoint& split)
+{
+    position_.emplace(position, CHECKERS_COPY::SEARCH);
+    control_ = parent.control_;
+    splitPoint_ = &split;
+    // the killers of the plies below the node are those of the parent; the history stays the worker's own
+    killers_ = parent.killers_;
+    searchDepth_ = parent.searchDepth_;
+    stopped_ = false;
+}
+
+void SearchWorker::resetCounters()
+{
+    nodes_ = 0;
+    quiescenceNodes_ = 0;
+    extensions_ = 0;
+    reductions_ = 0;
+    reductionResearches_ = 0;
+}
+
+bool SearchWorker::isMainThread() const
+{
+    return index_ == 0;
+}
+
+bool SearchWorker::shouldSkipDepth(int depth) const
+{
+    if (isMainThread()) {
+        return false;
+    }
+    const size_t i = static_cast<size_t>(index_ - 1) % kSkipSize.size();
+    return ((depth + kSkipPhase[i]) / kSkipSize[i]) % 2 != 0;
+}
+
+// Iterative deepening: every iteration starts with the best move of the previous one and fills the
+// transposition table for the next. An iteration cut by the hard deadline is thrown away.
+void SearchWorker::run()
+{
+    // nothing yields outside of the time-sliced search, so one resume runs it to the end
+    SearchTask<int> task = iterate();
+    task.getHandle().resume();
+}
+
+// The iterative deepening loop of run() and of the time-sliced search. Returns the depth of the last completed
+//   iteration
+SearchTask<int> SearchWorker::iterate()
+{
+    using Clock = std::chrono::steady_clock;
+
+    double softTimeScale = 1.0;
+    for (searchDepth_ = 1; searchDepth_ <= control_->maxDepth; ++searchDepth_) {
+        if (shouldSkipDepth(searchDepth_)) {
+            continue;
+        }
+
+        FlatMove iterationBestMove = result_.bestMove;
+        float score = 0.0f;
+        // The score rarely moves far between iterations, and a narrow window cuts more. A score outside of the
+        //   window is only a bound, so the iteration is repeated with a wider one
+        for (float window = kAspirationWindow;; window *= 2.0f) {
+            float alpha = -kInfinity;
+            float beta = kInfinity;
+            // multi-PV needs the scores of the next best moves too, an aspiration window would cut them off
+            if (searchDepth_ >= kAspirationMinDepth && result_.depth > 0 && window <= kMaxAspirationWindow
+                && std::abs(result_.score) < kDecisiveScore && control_->lineCount <= 1) {
+                alpha = result_.score - window;
+                beta = result_.score + window;
+            }
+            score = co_await searchRoot(alpha, beta, iterationBestMove);
+            if (stopped_ || (score > alpha && score < beta)) {
+                break;
+            }
+        }
+        if (stopped_) {
+            break;
+        }
+
+        // A best move that keeps changing needs more time to settle; a stable one gives some back
+        if (result_.depth > 0 && !(iterationBestMove == result_.bestMove)) {
+            softTimeScale = std::min(softTimeScale * kUnstableTimeFactor, kMaxSoftTimeScale);
+        } else {
+            softTimeScale = std::max(softTimeScale * kStableTimeFactor, 1.0);
+        }
+        result_.bestMove = iterationBestMove;
+        result_.line = pv_[0];
+        result_.score = score;
+        result_.depth = searchDepth_;
+        // The next iteration searches the best move first, so its score is the bound for the other moves,
+        //   and the moves that came close right after it
+        std::stable_sort(rootMoves_.begin(), rootMoves_.end(), [](const RootMove& left, const RootMove& right) {
+            return left.score > right.score;
+        });
+        if (control_->lineCount > 0) {
+            collectRootLines();
+        }
+
+        // a won or lost game will not change with more depth (the random noise is below one point); the other
+        //   lines of a multi-PV search might
+        if (std::abs(score) >= kDecisiveScore && control_->lineCount <= 1) {
+            break;
+        }
+        // the next iteration takes at least as long as all of the previous ones together
+        if (isMainThread() && control_->softTime.count() > 0 && !isPondering()
+            && Clock::now() - control_->start >= control_->softTime * (softTimeScale * kNextIterationShare)) {
+            break;
+        }
+        if (control_->stop.load(std::memory_order_relaxed)) {
+            break;
+        }
+        co_await yieldIfSliceUsedUp();
+    }
+    co_return result_.depth;
+}
+
+// One iteration of iterative deepening: a principal variation search over the root moves in which the window
+//   shrinks with every move. The random noise of a move is a part of its score, so its subtree is searched with
+//   the window shifted by the noise and nothing has to be searched with a wider window because of it.
+// Multi-PV keeps the SearchControl::lineCount best scores instead of one: the window of a move starts at the
+//   worst of them, so the moves that cannot make it into the lines are still refuted with a null window, and only
+//   those that do are searched again for their exact score
+SearchTask<float> SearchWorker::searchRoot(float alpha, float beta, FlatMove& bestMove)
+{
+    Checkers& position = *position_;
+    const size_t lineCount = std::min(static_cast<size_t>(std::max(control_->lineCount, 1)), rootMoves_.size());
+    float bestScore = -kInfinity;
+    // the best exact scores of the iteration, best first; at most lineCount of them
+    std::vector<float> lineScores;
+    lineScores.reserve(lineCount + 1);
+
+    for (size_t i = 0; i < rootMoves_.size(); ++i) {
+        RootMove& root = rootMoves_[i];
+        MoveUndo undo;
+        position.doMove(root.move, undo);
+
+        const float moveAlpha = lineScores.size() < lineCount ? alpha : std::max(alpha, lineScores.back());
+        const float childAlpha = -(beta - root.noise);
+        const float childBeta = -(moveAlpha - root.noise);
+        const int childDepth = searchDepth_ - 1;
+        float score;
+        if (i < lineCount) {
+            score = root.noise - co_await searchNode(1, childDepth, position, childAlpha, childBeta);
+        } else {
+            score = root.noise - co_await searchNode(1, childDepth, position, childBeta - kNullWindow, childBeta);
+            if (score > moveAlpha && score < beta) {
+                score = root.noise - co_await searchNode(1, childDepth, position, childAlpha, childBeta);
+            }
+        }
+        position.undoMove(root.move, undo);
+        if (stopped_) {
+            break;
+        }
+
+        // a bound for the moves that failed low, still good enough to order the next iteration
+        root.score = score;
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = root.move;
+        }
+        if (score > moveAlpha) {
+            if (lineScores.empty() || score > lineScores.front()) {
+                updatePrincipalVariation(0, root.move);
+            }
+            lineScores.insert(std::upper_bound(lineScores.begin(), lineScores.end(), score, std::greater<>{}), score);
+            if (lineScores.size() > lineCount) {
+                lineScores.pop_back();
+            }
+            if (control_->lineCount > 0) {
+                root.line.moves[0] = LineMove::of(root.move);
+                std::copy_n(pv_[1].moves.begin(), pv_[1].length, root.line.moves.begin() + 1);
+                root.line.length = pv_[1].length + 1;
+                root.exactDepth = searchDepth_;
+            }
+        }
+        if (bestScore >= beta) {
+            break;
+        }
+        co_await yieldIfSliceUsedUp();
+    }
+    co_return bestScore;
+}
+
+// Recursive negamax function. `ply` is the distance from the root, `depth` the remaining depth (changed by
+//   reductions and extensions). `position` is changed with doMove() and restored with undoMove() before returning
+float SearchWorker::EvaluatePositionRecursive(int ply, int depth, Checkers& position, float alpha, float beta)
+{
+    pv_[static_cast<size_t>(ply)].length = 0;
+    if (depth <= 0) {
+        return quiescence(ply, 0, position, alpha, beta);
+    }
+    if (countNode(nodes_)) {
+        // the result is thrown away by search()
+        return 0.0f;
+    }
+    PackedMove hashMove;
+    if (float score; probeTransposition(depth, position, alpha, beta, hashMove, score)) {
+        return score;
+    }
+
+    const COLOUR colour = position.getCurrentColour();
+    StagedMoveGenerator moves{position, plyMoves_[static_cast<size_t>(ply)], hashMove,
+                              killers_[static_cast<size_t>(ply)], &history_[static_cast<size_t>(colour)]};
+    const FlatMove* move = moves.next();
+    if (move == nullptr) {
+        return kNoMovesScore;
+    }
+    const int childDepth = childDepthOf(ply, depth, moves);
+
+    NodeWindow node{alpha, beta};
+    // YBWC: once the node splits, its remaining moves and their scores from the parallel search
+    std::vector<FlatMove> brothers;
+    std::vector<std::optional<float>> brotherScores;
+    float splitAlpha = alpha;
+    int moveNumber = 0;
+    const auto nextMove = [&]() -> const FlatMove* {
+        if (brothers.empty()) {
+            return moves.next();
+        }
+        return static_cast<size_t>(moveNumber) < brothers.size() ? &brothers[static_cast<size_t>(moveNumber)] : nullptr;
+    };
+    for (; move != nullptr; move = nextMove(), ++moveNumber) {
+        if (moveNumber == 1 && canSplit(depth)) {
+            for (; move != nullptr; move = moves.next()) {
+                brothers.push_back(*move);
+            }
+            splitAlpha = node.alpha;
+            brotherScores = searchYoungBrothers(ply, depth, childDepth, position, brothers, node.alpha, beta);
+            if (stopped_) {
+                return 0.0f;
+            }
+            // a brother that failed high is all the node needs
+            const auto cutoff = std::find_if(brotherScores.begin(), brotherScores.end(), [beta](const auto& score) {
+                return score.has_value() && *score >= beta;
+            });
+            if (cutoff != brotherScores.end()) {
+                const FlatMove cutoffMove = brothers[static_cast<size_t>(cutoff - brotherScores.begin())];
+                brothers.assign(1, cutoffMove);
+                brotherScores.assign(1, *cutoff);
+            }
+            move = brothers.data();
+        }
+
+        MoveUndo undo;
+        position.doMove(*move, undo);
+
+        MoveSearch search{*this, depth, childDepth, moveNumber, *move, position, node.alpha, beta};
+        const std::optional<float> splitScore =
+            moveNumber == 0 || brotherScores.empty() ? std::nullopt : brotherScores[static_cast<size_t>(moveNumber - 1)];
+        float currentScore = 0.0f;
+        std::optional<ChildSearch> child;
+        // The brother was searched with the alpha of the split. A fail low is still one, and a fail high that
+        //   beats the current alpha too; in between it has to be proven against the current alpha
+        if (splitScore.has_value() && (*splitScore <= splitAlpha || *splitScore > node.alpha)) {
+            currentScore = *splitScore;
+            pv_[static_cast<size_t>(ply) + 1].length = 0;
+            child = search.afterNullWindow(currentScore);
+        } else {
+            child = search.first();
+        }
+        for (; child.has_value(); child = search.next(currentScore)) {
+            currentScore = -EvaluatePositionRecursive(ply + 1, child->depth, position, child->alpha, child->beta);
+        }
+        position.undoMove(*move, undo);
+        if (stopped_) {
+            return 0.0f;
+        }
+        if (recordScore(ply, depth, colour, *move, currentScore, node)) {
+            break;
+        }
+    }
+    return finishNode(depth, position, node);
+}
+
+// EvaluatePositionRecursive() for the time-sliced search: the same node as a coroutine that may suspend between
+//   its moves. Only the nodes far from the horizon are coroutines, the subtrees below kSliceHorizon are searched
+//   in one go (a few hundred nodes, a millisecond or less) and without the overhead of a coroutine frame per node
+SearchTask<float> SearchWorker::searchNode(int ply, int depth, Checkers& position, float alpha, float beta)
+{
+    if (!slice_.has_value() || depth <= kSliceHorizon) {
+        co_return EvaluatePositionRecursive(ply, depth, position, alpha, beta);
+    }
+
+    pv_[static_cast<size_t>(ply)].length = 0;
+    if (countNode(nodes_)) {
+        co_return 0.0f;
+    }
+    PackedMove hashMove;
+    if (float score; probeTransposition(depth, position, alpha, beta, hashMove, score)) {
+        co_return score;
+    }
+
+    const COLOUR colour = position.getCurrentColour();
+    StagedMoveGenerator moves{position, plyMoves_[static_cast<size_t>(ply)], hashMove,
+                              killers_[static_cast<size_t>(ply)], &history_[static_cast<size_t>(colour)]};
+    const FlatMove* move = moves.next();
+    if (move == nullptr) {
+        co_return kNoMovesScore;
+    }
+    const int childDepth = childDepthOf(ply, depth, moves);
+
+    NodeWindow node{alpha, beta};
+    for (int moveNumber = 0; move != nullptr; move = moves.next(), ++moveNumber) {
+        MoveUndo undo;
+        position.doMove(*move, undo);
+
+        MoveSearch search{*this, depth, childDepth, moveNumber, *move, position, node.alpha, beta};
+        float currentScore = 0.0f;
+        for (std::optional<ChildSearch> child = search.first(); child.has_value(); child = search.next(currentScore)) {
+            currentScore = -co_await searchNode(ply + 1, child->depth, position, child->alpha, child->beta);
+        }
+        position.undoMove(*move, undo);
+        if (stopped_) {
+            co_return 0.0f;
+        }
+        if (recordScore(ply, depth, colour, *move, currentScore, node)) {
+            break;
+        }
+        co_await yieldIfSliceUsedUp();
+    }
+    co_return finishNode(depth, position, node);
+}
+
+// A result of an earlier search that went at least as deep may answer right away (true, `score`);
+//   otherwise its best move is searched first. Nodes inside the principal variation are always searched
+//   so that the line is not cut short
+bool SearchWorker::probeTransposition(int depth, const Checkers& position, float alpha, float beta,
+                                      PackedMove& hashMove, float& score) const
+{
+    const bool isPvNode = beta - alpha > 2.0f * kNullWindow;  // not a null window, even after rounding
+    TTEntry entry;
+    if (!tt_.probe(position.getHash(), entry)) {
+        return false;
+    }
+    hashMove = entry.move;
+    if (!isPvNode && entry.depth >= depth) {
+        if (entry.bound == TT_BOUND::EXACT || (entry.bound == TT_BOUND::LOWER && entry.score >= beta)
+            || (entry.bound == TT_BOUND::UPPER && entry.score <= alpha)) {
+            score = entry.score;
+            return true;
+        }
+    }
+    return false;
+}
+
+// A forced reply (usually the only capture) costs no depth: the line is followed until there is a choice.
+//   The extensions of one line are limited, so that the per-ply tables are big enough
+int SearchWorker::childDepthOf(int ply, int depth, const StagedMoveGenerator& moves)
+{
+    if (config_.singleReplyExtension > 0 && moves.isSingleReply() && ply + depth < maxPly_) {
+        ++extensions_;
+        return std::min(depth - 1 + config_.singleReplyExtension, maxPly_ - ply - 1);
+    }
+    return depth - 1;
+}
+
+// Quiet moves ordered late rarely turn out best: they are searched shallower first and only get the full depth
+//   when they beat alpha anyway. Moves that leave a capture to the opponent are not reduced
+int SearchWorker::lateMoveReductionOf(int depth, int childDepth, int moveNumber, const FlatMove& move,
+                                      const Checkers& position) const
+{
+    if (config_.lateMoveReduction > 0 && depth >= config_.lateMoveReductionMinDepth
+        && moveNumber >= config_.lateMoveReductionFirstMove && !move.isCapture() && !position.hasCaptures()) {
+        return std::max(0, std::min(config_.lateMoveReduction, childDepth - 1));
+    }
+    return 0;
+}
+
+// Takes the score of a searched move into the node. True on a cutoff: the other moves are not needed
+bool SearchWorker::recordScore(int ply, int depth, COLOUR colour, const FlatMove& move, float score,
+                               NodeWindow& node)
+{
+    if (score > node.bestScore) {
+        node.bestScore = score;
+        node.bestMove = PackedMove::of(move);
+    }
+    if (score > node.alpha) {
+        node.alpha = score;
+        updatePrincipalVariation(ply, move);
+    }
+    if (node.alpha >= node.beta) {
+        if (!move.isCapture()) {
+            rememberCutoff(ply, colour, move, depth);
+        }
+        return true;
+    }
+    return false;
+}
+
+float SearchWorker::finishNode(int depth, const Checkers& position, const NodeWindow& node)
+{
+    TT_BOUND bound = TT_BOUND::EXACT;
+    if (node.bestScore <= node.originalAlpha) {
+        bound = TT_BOUND::UPPER;
+    } else if (node.bestScore >= node.beta) {
+        bound = TT_BOUND::LOWER;
+    }
+    tt_.store(position.getHash(), node.bestScore, depth, bound, node.bestMove);
+    return node.bestScore;
+}
+
+// The null window searches of a move after the first one, `position` is after the move (see MoveSearch)
+float SearchWorker::searchLateMove(int ply, int depth, int childDepth, int moveNumber, Checkers& position,
+                                   const FlatMove& move, float alpha)
+{
+    MoveSearch search{*this, depth, childDepth, moveNumber, move, position, alpha, kInfinity, true};
+    float score = 0.0f;
+    for (std::optional<ChildSearch> child = search.first(); child.has_value(); child = search.next(score)) {
+        score = -EvaluatePositionRecursive(ply + 1, child->depth, position, child->alpha, child->beta);
+    }
+    return score;
+}
+
+bool SearchWorker::canSplit(int depth) const
+{
+    return splitWorkers_ != nullptr && depth >= config_.minSplitDepth;
+}
+
+// Searches every brother with searchLateMove() on the pool; this thread helps until all of them are done.
+//   The score of a brother stays empty when it was cancelled or no worker was free for it
+std::vector<std::optional<float>> SearchWorker::searchYoungBrothers(int ply, int depth, int childDepth,
+                                                                    const Checkers& position,
+                                                                    const std::vector<FlatMove>& brothers,
+                                                                    float alpha, float beta)
+{
+    SplitPoint split;
+    split.parent = splitPoint_;
+    std::vector<std::optional<float>> scores(brothers.size());
+    {
+        TaskGroup group{splitWorkers_->getPool()};
+        for (size_t i = 0; i < brothers.size(); ++i) {
+            group.run([&, i]() {
+                if (split.isCancelled() || control_->stop.load(std::memory_order_relaxed)) {
+                    return;
+                }
+                SearchWorker* const spare = splitWorkers_->tryAcquire();
+                if (spare == nullptr) {
+                    return;
+                }
+                SearchWorker& worker = *spare;
+                worker.startSplitTask(*this, position, split);
+                Checkers& child = *worker.position_;
+                MoveUndo undo;
+                child.doMove(brothers[i], undo);
+                const int moveNumber = static_cast<int>(i) + 1;
+                const float score =
+                    worker.searchLateMove(ply, depth, childDepth, moveNumber, child, brothers[i], alpha);
+                if (!worker.stopped_) {
+                    scores[i] = score;
+                    if (score >= beta) {
+                        split.cutoff.store(true, std::memory_order_relaxed);
+                    }
+                }
+                splitWorkers_->release(worker);
+            });
+        }
+        group.wait();
+    }
+
+    // out of time, or a split above this node was cut off
+    if (control_->stop.load(std::memory_order_relaxed) || (splitPoint_ != nullptr && splitPoint_->isCancelled())) {
+        stopped_ = true;
+    }
+    return scores;
+}
+
+// Quiescence search below the horizon: a position with a pending capture is not evaluated, the capture is made
+//   first. Captures are mandatory, so there is no "stand pat" score while there are some.
+//   `captures` are those made since the horizon
+float SearchWorker::quiescence(int ply, int captures, Checkers& position, float alpha, float beta)
+{
+    if (countNode(quiescenceNodes_)) {
+        return 0.0f;
+    }
+
+    MoveList& moves = plyMoves_[static_cast<size_t>(ply)];
+    // after kMaxQuiescenceDepth captures whatever is on the board is evaluated; the horizon is at maxPly_ at the
+    //   deepest, so the move lists of the plies below it are enough
+    if (captures < kMaxQuiescenceDepth) {
+        position.generateCaptures(moves, CAPTURE_PATHS::MERGED);
+    } else {
+        moves.clear();
+    }
+    if (moves.empty()) {
+        if (!position.hasLegalMoves()) {
+            return kNoMovesScore;
+        }
+        return evaluateForSideToMove(position);
+    }
+
+    float bestScore = -kInfinity;
+    for (const auto& move : moves) {
+        MoveUndo undo;
+        position.doMove(move, undo);
+        const float currentScore = -quiescence(ply + 1, captures + 1, position, -beta, -alpha);
+        position.undoMove(move, undo);
+        if (stopped_) {
+            return 0.0f;
+        }
+
+        bestScore = std::max(bestScore, currentScore);
+        alpha = std::max(alpha, currentScore);
+        if (alpha >= beta) {
+            break;
+        }
+    }
+    return bestScore;
+}
+
+// Counts a node and checks the clock and the node limit every kNodesBetweenTimeChecks nodes. True when the search
+//   has to stop
+bool SearchWorker::countNode(uint64_t& counter)
+{
+    ++counter;
+    if (splitPoint_ != nullptr && splitPoint_->isCancelled()) {
+        stopped_ = true;
+    }
+    if (((nodes_ + quiescenceNodes_) & kNodesBetweenTimeChecks) == 0) {
+        control_->nodes.fetch_add(kNodesBetweenTimeChecks + 1, std::memory_order_relaxed);
+        // The main thread keeps the time, and so do the young brothers it waits for. The Lazy SMP helpers stop
+        //   when it is done
+        const bool keepsTime = isMainThread() || splitPoint_ != nullptr;
+        if ((keepsTime && (isPastHardDeadline() || isPastNodeLimit() || isStopRequested()))
+            || (!isMainThread() && control_->stop.load(std::memory_order_relaxed))) {
+            stopped_ = true;
+            control_->stop.store(true, std::memory_order_relaxed);
+        }
+    }
+    return stopped_;
+}
+
+// Triangular PV table: the line of a node is its best move followed by the line of the child
+void SearchWorker::updatePrincipalVariation(int ply, const FlatMove& move)
+{
+    PrincipalVariation& line = pv_[static_cast<size_t>(ply)];
+    const PrincipalVariation& childLine = pv_[static_cast<size_t>(ply) + 1];
+    line.moves[0] = LineMove::of(move);
+    std::copy_n(childLine.moves.begin(), childLine.length, line.moves.begin() + 1);
+    line.length = childLine.length + 1;
+}
+
+// The best moves with an exact score in the iteration just completed. The root moves are sorted by score, and
+//   the scores of the others are bounds below the worst of the lines
+void SearchWorker::collectRootLines()
+{
+    result_.lines.clear();
+    for (const RootMove& root : rootMoves_) {
+        if (result_.lines.size() == static_cast<size_t>(control_->lineCount)) {
+            break;
+        }
+        if (root.exactDepth == searchDepth_) {
+            result_.lines.push_back(RootLine{root.move, root.line, root.score});
+        }
+    }
+}
+
+// A quiet move that refutes one position often refutes its siblings: it becomes a killer of the ply and
+//   gains history, more for cutoffs far from the leaves
+void SearchWorker::rememberCutoff(int ply, COLOUR colour, const FlatMove& move, int depth)
+{
+    const PackedMove packed = PackedMove::of(move);
+    KillerMoves& killers = killers_[static_cast<size_t>(ply)];
+    if (killers[0] != packed) {
+        killers[1] = killers[0];
+        killers[0] = packed;
+    }
+
+    HistoryScores& history = history_[static_cast<size_t>(colour)];
+    int32_t& score = history[move.from][move.to()];
+    score += depth * depth;
+    if (score >= kMaxHistoryScore) {
+        ageHistory();
+    }
+}
+
+// Keeps the order learnt so far but lets new cutoffs outweigh it
+void SearchWorker::ageHistory()
+{
+    for (auto& side : history_) {
+        for (auto& from : side) {
+            for (auto& score : from) {
+                score /= 2;
+            }
+        }
+    }
+}
+
+bool SearchWorker::isPastHardDeadline() const
+{
+    // the first iteration always completes, so there is a move to return
+    return control_->hardTime.count() > 0 && searchDepth_ > 1 && !isPondering()
+           && std::chrono::steady_clock::now() >= control_->start + control_->hardTime;
+}
+
+// Like the hard deadline, but counted in the nodes of all the threads. Pondering does not change it
+bool SearchWorker::isPastNodeLimit() const
+{
+    return control_->maxNodes > 0 && searchDepth_ > 1
+           && control_->nodes.load(std::memory_order_relaxed) >= control_->maxNodes;
+}
+
+// Unlike the hard deadline, a stop request may end the first iteration: the best move so far is the first root move
+bool SearchWorker::isStopRequested() const
+{
+    return control_->stopRequested != nullptr && control_->stopRequested->load(std::memory_order_relaxed);
+}
+
+bool SearchWorker::isPondering() const
+{
+    return control_->pondering != nullptr && control_->pondering->load(std::memory_order_relaxed);
+}
+
+const SearchWorker::IterationResult& SearchWorker::getResult() const
+{
+    return result_;
+}
+
+uint64_t SearchWorker::getNodeCount() const
+{
+    return nodes_ + quiescenceNodes_;
+}
+
+uint64_t SearchWorker::getQuiescenceNodeCount() const
+{
+    return quiescenceNodes_;
+}
+
+SelectivityStats SearchWorker::getSelectivityStats() const
+{
+    return {extensions_, reductions_, reductionResearches_};
+}
+
+bool SplitPoint::isCancelled() const
+{
+    for (const SplitPoint* split = this; split != nullptr; split = split->parent) {
+        if (split->cutoff.load(std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+SplitWorkers::SplitWorkers(const MinimaxConfig& config, TranspositionTable& tt, int threads) :
+    config_{config},
+    tt_{tt},
+    // the pool's threads and the one that started the search
+    maxWorkers_{static_cast<size_t>(threads) + 1},
+    pool_{threads}
+{
+}
+
+WorkStealingPool& SplitWorkers::getPool()
+{
+    return pool_;
+}
+
+// Workers are created on demand and kept for the next searches: their move lists are too big to allocate per task
+SearchWorker* SplitWorkers::tryAcquire()
+{
+    std::lock_guard lock{mutex_};
+    if (idle_.empty()) {
+        if (workers_.size() >= maxWorkers_) {
+            return nullptr;
+        }
+        // index 0 is the main thread
+        workers_.push_back(std::make_unique<SearchWorker>(config_, tt_, static_cast<int>(workers_.size()) + 1, this));
+        return workers_.back().get();
+    }
+    SearchWorker* worker = idle_.back();
+    idle_.pop_back();
+    return worker;
+}
+
+void SplitWorkers::release(SearchWorker& worker)
+{
+    std::lock_guard lock{mutex_};
+    idle_.push_back(&worker);
+}
+
+const std::vector<std::unique_ptr<SearchWorker>>& SplitWorkers::getWorkers() const
+{
+    return workers_;
+}
@@ -0,0 +1,242 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "Checkers.hpp"
+#include "MinimaxEngine.hpp"
+#include "Move.hpp"
+#include "MoveList.hpp"
+#include "SearchTask.hpp"
+#include "StagedMoveGenerator.hpp"
+#include "TranspositionTable.hpp"
+#include "WorkStealingPool.hpp"
+
+class SplitWorkers;
+
+// Shared by the threads of one MinimaxEngine::search()
+struct SearchControl {
+    std::chrono::steady_clock::time_point start;
+    // the tighter of the MinimaxConfig and the SearchLimits ones; 0 is no limit
+    int maxDepth{kMaxSearchDepth};
+    uint64_t maxNodes{0};
+    std::chrono::milliseconds softTime{0};
+    std::chrono::milliseconds hardTime{0};
+    // MinimaxEngine::analyse(): root moves whose exact scores and lines are wanted (multi-PV). 0 when playing
+    int lineCount{0};
+    // visited by all the threads, counted in steps of 1024 from each
+    std::atomic<uint64_t> nodes{0};
+    // set by the main thread when it is done (or out of time), the helpers stop then
+    std::atomic<bool> stop{false};
+    // Engine::requestStop() of the engine, seen by the threads that keep the time
+    const std::atomic<bool>* stopRequested{nullptr};
+    // Engine::setPondering(): no time limit while it is set
+    const std::atomic<bool>* pondering{nullptr};
+};
+
+// A node whose young brothers are searched in parallel (YBWC). A cutoff cancels the brothers still running,
+//   and everything split below them
+struct SplitPoint {
+    const SplitPoint* parent{nullptr};
+    std::atomic<bool> cutoff{false};
+
+    [[nodiscard]] bool isCancelled() const;
+};
+
+/**
+ * Iterative deepening search of one thread. It owns everything the search writes except the transposition
+ * table: the position copy, the per-ply move lists, killers, history and PV table.
+ * Worker 0 is the main thread; the others are Lazy SMP helpers or search the young brothers of split nodes
+ * (see SearchWorker.cpp).
+ */
+class SearchWorker {
+public:
+    // A move of a reported line. Unlike the tag of PackedMove, the captured set tells apart the merged captures
+    //   with the same origin and final square
+    struct LineMove {
+        Bitboard128 captured{};
+        uint8_t from{kNoSquare};
+        uint8_t to{kNoSquare};
+
+        [[nodiscard]] static LineMove of(const FlatMove& move)
+        {
+            return LineMove{move.captured, move.from, static_cast<uint8_t>(move.to())};
+        }
+
+        [[nodiscard]] bool matches(const FlatMove& move) const
+        {
+            return move.isValid() && from == move.from && to == move.to() && captured == move.captured;
+        }
+    };
+
+    // triangular table of the best line found below every ply
+    struct PrincipalVariation {
+        std::array<LineMove, kMaxSearchDepth + kMaxSearchExtension> moves{};
+        int length{0};
+    };
+
+    struct RootMove {
+        FlatMove move;
+        float noise{0.0f};  // added to the score of the move, fixed for one search()
+        float score{0.0f};  // in the last completed iteration, used to order the next one
+        // multi-PV: the line of the move, and the iteration in which `score` was exact and not only a bound
+        PrincipalVariation line{};
+        int exactDepth{0};
+    };
+
+    // one of the best root moves of a multi-PV search, and its line (starting with it)
+    struct RootLine {
+        FlatMove move;
+        PrincipalVariation line;
+        float score{0.0f};
+    };
+
+    // what the last completed iteration found
+    struct IterationResult {
+        FlatMove bestMove;
+        PrincipalVariation line;
+        float score{0.0f};
+        int depth{0};  // 0 before the first iteration completes
+        // multi-PV only: the SearchControl::lineCount best moves, best first
+        std::vector<RootLine> lines;
+    };
+
+private:
+    // the bounds and the best move of a node while its moves are searched
+    struct NodeWindow;
+    // the depth and window of a child search, and the child searches of one move in order
+    struct ChildSearch;
+    class MoveSearch;
+
+    // the running slice of the time-sliced search and the coroutine to resume with the next one
+    struct SliceState {
+        SearchSlice budget;
+        uint64_t startNodes{0};
+        std::chrono::steady_clock::time_point start;
+        std::coroutine_handle<> suspended;
+    };
+    // awaited between moves: suspends the whole search when the slice is used up
+    struct SliceYield;
+
+    const MinimaxConfig& config_;
+    TranspositionTable& tt_;
+    const int index_;
+    // deepest ply of the main search, extensions included
+    const int maxPly_;
+    SearchControl* control_{nullptr};
+    // YBWC: where the young brothers go (nullptr without YBWC), and the node this worker searches a brother of
+    SplitWorkers* splitWorkers_;
+    const SplitPoint* splitPoint_{nullptr};
+
+    // copied from the game for every search (Checkers can be copied but not assigned)
+    std::optional<Checkers> position_;
+    std::vector<RootMove> rootMoves_;
+    // move list of every ply (the quiescence plies too), allocated once so that the search itself never allocates
+    std::vector<MoveList> plyMoves_;
+    // move ordering: killer moves of every ply and the history of quiet cutoffs of each side
+    std::vector<KillerMoves> killers_;
+    std::array<HistoryScores, 2> history_{};
+    std::vector<PrincipalVariation> pv_;
+    IterationResult result_;
+
+    // state of the running search
+    int searchDepth_{0};
+    bool stopped_{false};
+    uint64_t nodes_{0};
+    uint64_t quiescenceNodes_{0};
+    uint64_t extensions_{0};
+    uint64_t reductions_{0};
+    uint64_t reductionResearches_{0};
+    // time-sliced search only
+    std::optional<SliceState> slice_;
+    std::optional<SearchTask<int>> slicedTask_;
+
+    [[nodiscard]] bool isMainThread() const;
+    [[nodiscard]] bool shouldSkipDepth(int depth) const;
+    SearchTask<int> iterate();
+    SearchTask<float> searchRoot(float alpha, float beta, FlatMove& bestMove);
+    SearchTask<float> searchNode(int ply, int depth, Checkers& position, float alpha, float beta);
+    float EvaluatePositionRecursive(int ply, int depth, Checkers& position, float alpha, float beta);
+    bool probeTransposition(int depth, const Checkers& position, float alpha, float beta, PackedMove& hashMove,
+                            float& score) const;
+    int childDepthOf(int ply, int depth, const StagedMoveGenerator& moves);
+    [[nodiscard]] int lateMoveReductionOf(int depth, int childDepth, int moveNumber, const FlatMove& move,
+                                          const Checkers& position) const;
+    bool recordScore(int ply, int depth, COLOUR colour, const FlatMove& move, float score, NodeWindow& node);
+    float finishNode(int depth, const Checkers& position, const NodeWindow& node);
+    [[nodiscard]] bool isSliceUsedUp() const;
+    [[nodiscard]] SliceYield yieldIfSliceUsedUp();
+    float searchLateMove(int ply, int depth, int childDepth, int moveNumber, Checkers& position, const FlatMove& move,
+                         float alpha);
+    [[nodiscard]] bool canSplit(int depth) const;
+    std::vector<std::optional<float>> searchYoungBrothers(int ply, int depth, int childDepth, const Checkers& position,
+                                                          const std::vector<FlatMove>& brothers, float alpha,
+                                                          float beta);
+    float quiescence(int ply, int captures, Checkers& position, float alpha, float beta);
+    bool countNode(uint64_t& counter);
+    void updatePrincipalVariation(int ply, const FlatMove& move);
+    void collectRootLines();
+    [[nodiscard]] bool isPastHardDeadline() const;
+    [[nodiscard]] bool isPastNodeLimit() const;
+    [[nodiscard]] bool isStopRequested() const;
+    [[nodiscard]] bool isPondering() const;
+    void rememberCutoff(int ply, COLOUR colour, const FlatMove& move, int depth);
+    void ageHistory();
+
+public:
+    // `index` 0 is the main thread: it keeps the time, the others skip some depths and stop with it.
+    //   With `splitWorkers` the nodes of the search are split between its threads (YBWC)
+    SearchWorker(const MinimaxConfig& config, TranspositionTable& tt, int index, SplitWorkers* splitWorkers = nullptr);
+
+    // `rootMoves` are the legal moves of `position` with their noise; `control` outlives the search
+    void startSearch(const Checkers& position, const std::vector<RootMove>& rootMoves, SearchControl& control);
+    // Deepens until the limits of `control` are reached (main thread) or until `control.stop` (helpers)
+    void run();
+    // The search of run() on the calling thread in slices: startSlicedSearch() after startSearch(), then
+    //   resumeSlice() until it returns true
+    void startSlicedSearch();
+    bool resumeSlice(const SearchSlice& slice);
+    // Prepares the worker to search one young brother of `split` (a node of `parent` in `position`)
+    void startSplitTask(const SearchWorker& parent, const Checkers& position, const SplitPoint& split);
+    void resetCounters();
+
+    [[nodiscard]] const IterationResult& getResult() const;
+    [[nodiscard]] uint64_t getNodeCount() const;
+    [[nodiscard]] uint64_t getQuiescenceNodeCount() const;
+    [[nodiscard]] SelectivityStats getSelectivityStats() const;
+};
+
+/**
+ * The threads and the spare workers of YBWC. A young brother is searched by whichever pool thread takes it, with
+ * a worker of its own taken from here, because the thread may be waiting for its own split with a worker
+ * that is in the middle of a search.
+ */
+class SplitWorkers {
+private:
+    const MinimaxConfig& config_;
+    TranspositionTable& tt_;
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<SearchWorker>> workers_;
+    std::vector<SearchWorker*> idle_;
+    // a worker is a few MB of move lists, so there are no more of them than the search has threads
+    const size_t maxWorkers_;
+    // last, so that its threads are joined before the workers go
+    WorkStealingPool pool_;
+
+public:
+    SplitWorkers(const MinimaxConfig& config, TranspositionTable& tt, int threads);
+
+    [[nodiscard]] WorkStealingPool& getPool();
+    // nullptr when all the workers are busy
+    [[nodiscard]] SearchWorker* tryAcquire();
+    void release(SearchWorker& worker);
+    // every worker ever acquired, for the statistics; only read while nothing is searching
+    [[nodiscard]] const std::vector<std::unique_ptr<SearchWorker>>& getWorkers() const;
+};
@@ -0,0 +1,146 @@
+#include "TranspositionTable.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+namespace
+{
+// Layout of Slot::data
+constexpr int kDepthShift = 32;
+constexpr int kBoundShift = 39;
+constexpr int kFromShift = 41;
+constexpr int kToShift = 48;
+constexpr int kTagShift = 55;
+constexpr int kAgeShift = 60;
+
+constexpr uint64_t kDepthMask = 0x7F;
+constexpr uint64_t kBoundMask = 0x3;
+constexpr uint64_t kSquareMask = 0x7F;
+constexpr uint64_t kTagMask = (1 << PackedMove::kCaptureTagBits) - 1;
+constexpr uint64_t kAgeMask = 0xF;
+
+static_assert(kAgeShift + 4 == 64 && kTagShift + PackedMove::kCaptureTagBits == kAgeShift);
+
+uint64_t packSquare(uint8_t square)
+{
+    return square == kNoSquare ? kSquareMask : square;
+}
+
+uint8_t unpackSquare(uint64_t square)
+{
+    return square == kSquareMask ? kNoSquare : static_cast<uint8_t>(square);
+}
+
+uint64_t pack(float score, int depth, TT_BOUND bound, PackedMove move, uint8_t age)
+{
+    return static_cast<uint64_t>(std::bit_cast<uint32_t>(score))
+           | (static_cast<uint64_t>(std::clamp(depth, 0, static_cast<int>(kDepthMask))) << kDepthShift)
+           | (static_cast<uint64_t>(bound) << kBoundShift) | (packSquare(move.from) << kFromShift)
+           | (packSquare(move.to) << kToShift) | ((move.captureTag & kTagMask) << kTagShift)
+           | ((age & kAgeMask) << kAgeShift);
+}
+
+TTEntry unpack(uint64_t data)
+{
+    TTEntry entry;
+    entry.score = std::bit_cast<float>(static_cast<uint32_t>(data));
+    entry.depth = static_cast<int>((data >> kDepthShift) & kDepthMask);
+    entry.bound = static_cast<TT_BOUND>((data >> kBoundShift) & kBoundMask);
+    entry.move.from = unpackSquare((data >> kFromShift) & kSquareMask);
+    entry.move.to = unpackSquare((data >> kToShift) & kSquareMask);
+    entry.move.captureTag = static_cast<uint8_t>((data >> kTagShift) & kTagMask);
+    return entry;
+}
+
+uint8_t ageOf(uint64_t data)
+{
+    return static_cast<uint8_t>((data >> kAgeShift) & kAgeMask);
+}
+}  // namespace
+
+TranspositionTable::TranspositionTable(size_t sizeMb)
+{
+    resize(sizeMb);
+}
+
+void TranspositionTable::resize(size_t sizeMb)
+{
+    const size_t wanted = std::max<size_t>(sizeMb * 1024 * 1024 / sizeof(Bucket), 1);
+    bucketCount_ = std::bit_floor(wanted);
+    buckets_ = std::make_unique<Bucket[]>(bucketCount_);
+}
+
+void TranspositionTable::clear()
+{
+    for (size_t i = 0; i < bucketCount_; ++i) {
+        for (auto& slot : buckets_[i].slots) {
+            slot.check.store(0, std::memory_order_relaxed);
+            slot.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    age_ = 0;
+}
+
+void TranspositionTable::newSearch()
+{
+    age_ = static_cast<uint8_t>((age_ + 1) & kAgeMask);
+}
+
+TranspositionTable::Bucket& TranspositionTable::bucketFor(uint64_t key) const
+{
+    return buckets_[key & (bucketCount_ - 1)];
+}
+
+bool TranspositionTable::probe(uint64_t key, TTEntry& entry) const
+{
+    for (const auto& slot : bucketFor(key).slots) {
+        const uint64_t data = slot.data.load(std::memory_order_relaxed);
+        if ((slot.check.load(std::memory_order_relaxed) ^ data) == key) {
+            entry = unpack(data);
+            return entry.bound != TT_BOUND::NONE;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::store(uint64_t key, float score, int depth, TT_BOUND bound, PackedMove move)
+{
+    Bucket& bucket = bucketFor(key);
+
+    // The same position, otherwise the least valuable entry: shallow ones from older searches go first
+    Slot* victim = &bucket.slots[0];
+    int victimValue = std::numeric_limits<int>::max();
+    for (auto& slot : bucket.slots) {
+        const uint64_t data = slot.data.load(std::memory_order_relaxed);
+        if ((slot.check.load(std::memory_order_relaxed) ^ data) == key) {
+            const TTEntry old = unpack(data);
+            // keep a deeper result of the current search, and the old move when the new result has none
+            if (old.bound != TT_BOUND::NONE && ageOf(data) == age_ && old.depth > depth && bound != TT_BOUND::EXACT) {
+                return;
+            }
+            if (!move.isValid()) {
+                move = old.move;
+            }
+            victim = &slot;
+            break;
+        }
+
+        const TTEntry entry = unpack(data);
+        const int staleness = (age_ - ageOf(data)) & static_cast<int>(kAgeMask);
+        const int value = entry.bound == TT_BOUND::NONE ? -1 : entry.depth - 8 * staleness;
+        if (value < victimValue) {
+            victimValue = value;
+            victim = &slot;
+        }
+    }
+
+    const uint64_t data = pack(score, depth, bound, move, age_);
+    victim->data.store(data, std::memory_order_relaxed);
+    victim->check.store(key ^ data, std::memory_order_relaxed);
+}
+
+size_t TranspositionTable::getSizeBytes() const
+{
+    return bucketCount_ * sizeof(Bucket);
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "Move.hpp"
+
+enum class TT_BOUND : uint8_t {
+    NONE = 0,
+    EXACT,
+    LOWER,  // the real score is at least `score` (fail high)
+    UPPER,  // the real score is at most `score` (fail low)
+};
+
+struct TTEntry {
+    float score{0.0f};
+    int depth{0};
+    TT_BOUND bound{TT_BOUND::NONE};
+    PackedMove move;
+};
+
+/**
+ * Fixed-size hash table of search results, indexed by the Zobrist key of the position.
+ *
+ * Buckets of four entries fill one cache line. Every entry is two relaxed atomic words: the packed data and
+ * the key XOR-ed with it. A reader that sees a half-written entry gets a key that does not match and treats
+ * it as a miss, so several search threads can share the table without locks.
+ */
+class TranspositionTable {
+private:
+    struct Slot {
+        std::atomic<uint64_t> check{0};  // key ^ data
+        std::atomic<uint64_t> data{0};
+    };
+
+    static constexpr int kBucketSize = 4;
+
+    struct alignas(64) Bucket {
+        std::array<Slot, kBucketSize> slots;
+    };
+
+    std::unique_ptr<Bucket[]> buckets_;
+    size_t bucketCount_{0};
+    uint8_t age_{0};
+
+    [[nodiscard]] Bucket& bucketFor(uint64_t key) const;
+
+public:
+    explicit TranspositionTable(size_t sizeMb);
+
+    // Rounded down to a power of two number of buckets, at least one
+    void resize(size_t sizeMb);
+    void clear();
+    // Called once per getBestMove(): entries of older searches are replaced first
+    void newSearch();
+
+    bool probe(uint64_t key, TTEntry& entry) const;
+    void store(uint64_t key, float score, int depth, TT_BOUND bound, PackedMove move);
+
+    [[nodiscard]] size_t getSizeBytes() const;
+};
@@ -0,0 +1,179 @@
+#include "WorkStealingPool.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+// Index of the pool worker running on this thread, kNotAWorker outside of the pool
+constexpr size_t kNotAWorker = static_cast<size_t>(-1);
+thread_local const WorkStealingPool* currentPool = nullptr;
+thread_local size_t currentWorker = kNotAWorker;
+// Group of the task running on this thread, the parent of the groups it creates
+thread_local const TaskGroup* currentGroup = nullptr;
+}  // namespace
+
+WorkStealingPool::WorkStealingPool(int threads)
+{
+    if (threads < 1) {
+        throw std::logic_error("WorkStealingPool needs at least one thread");
+    }
+    for (int i = 0; i < threads; ++i) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+    for (size_t i = 0; i < queues_.size(); ++i) {
+        threads_.emplace_back([this, i]() {
+            workerLoop(i);
+        });
+    }
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard lock{sleepMutex_};
+        stopping_.store(true);
+    }
+    wakeUp_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+void WorkStealingPool::submit(std::function<void()> task, const TaskGroup* group)
+{
+    const size_t index = currentPool == this ? currentWorker : nextQueue_.fetch_add(1) % queues_.size();
+    {
+        std::lock_guard lock{queues_[index]->mutex};
+        queues_[index]->tasks.push_back(Task{std::move(task), group});
+    }
+    {
+        // under the sleep mutex, so that a worker about to sleep sees the task or gets the notification
+        std::lock_guard lock{sleepMutex_};
+        queued_.fetch_add(1);
+    }
+    wakeUp_.notify_one();
+}
+
+// The newest task of the own deque that is `within` (any task for nullptr)
+bool WorkStealingPool::popOwn(size_t index, const TaskGroup* within, Task& task)
+{
+    Queue& queue = *queues_[index];
+    std::lock_guard lock{queue.mutex};
+    const auto it = std::find_if(queue.tasks.rbegin(), queue.tasks.rend(), [within](const Task& queued) {
+        return within == nullptr || within->contains(queued.group);
+    });
+    if (it == queue.tasks.rend()) {
+        return false;
+    }
+    task = std::move(*it);
+    queue.tasks.erase(std::next(it).base());
+    queued_.fetch_sub(1);
+    return true;
+}
+
+// The oldest task that is `within` (any task for nullptr) from the deques of the others
+bool WorkStealingPool::steal(size_t thief, const TaskGroup* within, Task& task)
+{
+    // every thief starts with its right neighbour, so they do not all hit the same deque
+    const size_t start = thief == kNotAWorker ? nextQueue_.load() : thief + 1;
+    for (size_t i = 0; i < queues_.size(); ++i) {
+        Queue& queue = *queues_[(start + i) % queues_.size()];
+        std::lock_guard lock{queue.mutex};
+        const auto it = std::find_if(queue.tasks.begin(), queue.tasks.end(), [within](const Task& queued) {
+            return within == nullptr || within->contains(queued.group);
+        });
+        if (it != queue.tasks.end()) {
+            task = std::move(*it);
+            queue.tasks.erase(it);
+            queued_.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::runTask(Task& task)
+{
+    const TaskGroup* const outerGroup = currentGroup;
+    currentGroup = task.group;
+    task.run();
+    currentGroup = outerGroup;
+}
+
+bool WorkStealingPool::runPendingTask(const TaskGroup* within)
+{
+    const size_t self = currentPool == this ? currentWorker : kNotAWorker;
+    Task task;
+    if ((self != kNotAWorker && popOwn(self, within, task)) || steal(self, within, task)) {
+        runTask(task);
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingPool::workerLoop(size_t index)
+{
+    currentPool = this;
+    currentWorker = index;
+    while (true) {
+        if (runPendingTask()) {
+            continue;
+        }
+        std::unique_lock lock{sleepMutex_};
+        wakeUp_.wait(lock, [this]() {
+            return stopping_.load() || queued_.load() > 0;
+        });
+        if (stopping_.load()) {
+            return;
+        }
+    }
+}
+
+int WorkStealingPool::getThreadCount() const
+{
+    return static_cast<int>(threads_.size());
+}
+
+TaskGroup::TaskGroup(WorkStealingPool& pool) : pool_{pool}, parent_{currentGroup}
+{
+}
+
+TaskGroup::~TaskGroup()
+{
+    wait();
+}
+
+void TaskGroup::run(std::function<void()> task)
+{
+    pending_.fetch_add(1);
+    pool_.submit(
+        [this, task = std::move(task)]() {
+            task();
+            pending_.fetch_sub(1, std::memory_order_release);
+        },
+        this);
+}
+
+void TaskGroup::wait()
+{
+    while (pending_.load(std::memory_order_acquire) > 0) {
+        // the tasks of this group may be running elsewhere; until they finish, help with what they split off
+        if (!pool_.runPendingTask(this)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+// The groups of a task that is still queued are alive: every group up the chain waits for a running task
+bool TaskGroup::contains(const TaskGroup* group) const
+{
+    for (; group != nullptr; group = group->parent_) {
+        if (group == this) {
+            return true;
+        }
+    }
+    return false;
+}
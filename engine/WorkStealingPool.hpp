@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class TaskGroup;
+
+/**
+ * Fixed set of threads with one task deque each. A worker takes its newest task from the back of its own
+ * deque (the most recently split work, still warm in its caches) and, when it is empty, steals the oldest
+ * task from the front of another deque (the biggest piece of work left). Threads outside of the pool submit
+ * round robin.
+ *
+ * Nothing in the pool knows about checkers: the search splits with it, and perft or self-play can run their
+ * independent jobs on it the same way. Tasks must not throw.
+ */
+class WorkStealingPool {
+private:
+    struct Task {
+        std::function<void()> run;
+        // the TaskGroup waiting for the task, nullptr for none
+        const TaskGroup* group{nullptr};
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> threads_;
+    std::atomic<size_t> nextQueue_{0};
+    // tasks sitting in the deques, idle workers sleep while it is 0
+    std::atomic<size_t> queued_{0};
+    std::atomic<bool> stopping_{false};
+    std::mutex sleepMutex_;
+    std::condition_variable wakeUp_;
+
+    void workerLoop(size_t index);
+    bool popOwn(size_t index, const TaskGroup* within, Task& task);
+    bool steal(size_t thief, const TaskGroup* within, Task& task);
+    static void runTask(Task& task);
+
+public:
+    explicit WorkStealingPool(int threads);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // `group` is the TaskGroup that waits for the task, if any
+    void submit(std::function<void()> task, const TaskGroup* group = nullptr);
+    // Runs one queued task on the calling thread (own deque first when called from a worker); with `within` only
+    //   a task of that group or of a group created by its tasks. False when there was nothing to run
+    bool runPendingTask(const TaskGroup* within = nullptr);
+
+    [[nodiscard]] int getThreadCount() const;
+};
+
+/**
+ * Tasks that are waited for together. wait() does not block while there is work: the waiting thread runs
+ * queued tasks of this group, so tasks may split again and wait without running out of threads. The groups
+ * created inside the tasks are its descendants and their tasks are run too; unrelated tasks are not, as one
+ * of them could keep the thread long after its own tasks are done.
+ */
+class TaskGroup {
+private:
+    WorkStealingPool& pool_;
+    // the group of the task that created this one, nullptr outside of tasks
+    const TaskGroup* const parent_;
+    std::atomic<size_t> pending_{0};
+
+public:
+    explicit TaskGroup(WorkStealingPool& pool);
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    void run(std::function<void()> task);
+    void wait();
+
+    // True for this group and its descendants
+    [[nodiscard]] bool contains(const TaskGroup* group) const;
+};
@@ -1,6 +1,8 @@
 #include "PlayState.hpp"
 
 #include <algorithm>
+#include <chrono>
+#include <optional>
 #include <stdexcept>
 #include <utility>
 
@@ -21,6 +23,18 @@ constexpr float kResultMessageGapFactor = 0.06f;
 constexpr unsigned int kMinResultMessageCharacterSize = 16;
 constexpr unsigned int kMaxResultMessageCharacterSize = 24;
 
+#ifdef LPC_SINGLE_THREADED
+constexpr ASYNC_MODE kEngineSearchMode = ASYNC_MODE::TIME_SLICED;
+#else
+constexpr ASYNC_MODE kEngineSearchMode = ASYNC_MODE::THREAD;
+#endif
+// Time-sliced search: the frame time at 50 FPS (Game::Game), and the search time per frame that is fitted into it
+constexpr std::chrono::microseconds kFrameTime{20000};
+constexpr std::chrono::microseconds kFrameTimeSlack{2000};
+constexpr std::chrono::microseconds kMinSearchSlice{1000};
+constexpr std::chrono::microseconds kMaxSearchSlice{16000};
+constexpr std::chrono::microseconds kSearchSliceStep{500};
+
 bool hasPrimaryShortcutModifier(const sf::Event::KeyPressed& key)
 {
 #ifdef __APPLE__
@@ -320,6 +334,7 @@ void PlayState::handleEvent(const sf::Event& event)
 
     if (const auto* keyPressed = event.getIf<sf::Event::KeyPressed>(); keyPressed != nullptr) {
         if (keyPressed->code == sf::Keyboard::Key::Escape) {
+            cancelComputerSearch();
             stopResultSounds();
             stateManager_.setActiveState(STATE_TYPE::MenuState);
             return;
@@ -380,6 +395,7 @@ void PlayState::enterGameOverState(COLOUR winner)
     isGameOver_ = true;
     winnerColor_ = winner;
     resultClock_.restart();
+    cancelComputerSearch();
 
     if (shouldPlaySound) {
         playComputerResultSound();
@@ -426,6 +442,7 @@ void PlayState::undoMove()
         return;
     }
 
+    cancelComputerSearch();
     bool hasChanged = false;
     if (gameContext_.mode == MODE::COMPUTER) {
         while (checkers_.canUndo()) {
@@ -454,6 +471,7 @@ void PlayState::redoMove()
         return;
     }
 
+    cancelComputerSearch();
     bool hasChanged = false;
     if (gameContext_.mode == MODE::COMPUTER) {
         while (checkers_.canRedo()) {
@@ -492,7 +510,18 @@ void PlayState::triggerComputerMoveIfNeeded()
         return;
     }
 
-    moveState_.resolvedPath = engine_->getBestMove();
+    // The search runs while the frames go on; the move is picked up by a later update().
+    //   A ponder of this position becomes the search, any other ponder is dropped
+    if (!engine_->isSearching() || engine_->isPondering()) {
+        engine_->startSearch(checkers_);
+        return;
+    }
+    std::optional<Move> move = engine_->tryGetResult();
+    if (!move.has_value()) {
+        return;
+    }
+
+    moveState_.resolvedPath = std::move(*move);
     moveState_.from = moveState_.resolvedPath.from;
     moveState_.to = getLastPositionInChain(moveState_.resolvedPath);
     moveState_.hasResolvedPath = true;
@@ -500,9 +529,56 @@ void PlayState::triggerComputerMoveIfNeeded()
     moveState_.inProgress = true;
 }
 
+void PlayState::startComputerSearchForResolvedMove()
+{
+    // Only a ponder may run during the human's turn; anything else is already the search for this move
+    if (gameContext_.mode != MODE::COMPUTER || !moveState_.hasResolvedPath || !isHumanTurn() ||
+        (engine_->isSearching() && !engine_->isPondering())) {
+        return;
+    }
+
+    Checkers afterMove{checkers_};
+    afterMove.makeMoveWithoutHistory(moveState_.resolvedPath);
+    if (!afterMove.getResult().isOver) {
+        engine_->startSearch(afterMove);
+    } else {
+        // the move ends the game: nothing to search, and a ponder of another reply would run on to its depth limit
+        cancelComputerSearch();
+    }
+}
+
+void PlayState::cancelComputerSearch()
+{
+    if (engine_ != nullptr) {
+        engine_->cancel();
+    }
+}
+
+void PlayState::adaptSearchSlice()
+{
+    const std::chrono::microseconds frameTime{frameClock_.restart().asMicroseconds()};
+    if (engine_ == nullptr || !engine_->isSearching()) {
+        return;
+    }
+
+    // Frames that take longer than the frame rate allows give search time back quickly, shorter ones take
+    //   a little more
+    if (frameTime > kFrameTime + kFrameTimeSlack) {
+        searchSlice_ = std::max(kMinSearchSlice, searchSlice_ * 3 / 4);
+    } else {
+        searchSlice_ = std::min(kMaxSearchSlice, searchSlice_ + kSearchSliceStep);
+    }
+    engine_->setSlice(SearchSlice{.maxTime = searchSlice_});
+    // the one slice of the frame, also while the human's move is still animated; triggerComputerMoveIfNeeded()
+    //   only takes the move
+    engine_->runSlice();
+}
+
 void PlayState::update()
 {
+    adaptSearchSlice();
     updateGameResultState();
+    startComputerSearchForResolvedMove();
     triggerComputerMoveIfNeeded();
 }
 
@@ -677,9 +753,15 @@ void PlayState::commitResolvedMoveIfNeeded()
 
     // Commit only once after animation finished
     moveState_.hasResolvedPath = false;
+    const bool isComputerMove = !isHumanTurn();
     checkers_.makeMove(moveState_.resolvedPath);
     boardView_ = checkers_.getCopyBoard();
     clearSelection();
+
+    // The human thinks now: the engine searches the reply it expects meanwhile
+    if (isComputerMove && gameContext_.mode == MODE::COMPUTER && !checkers_.getResult().isOver) {
+        engine_->startPondering(checkers_);
+    }
 }
 
 void PlayState::processMoveAnimation()
@@ -697,9 +779,9 @@ void PlayState::processMoveAnimation()
     } else {
         // Ambiguous chained capture visualization: move one segment and wait for next click
         const Position previousFrom = moveState_.from;
-        std::swap(boardView_(moveState_.to), boardView_(moveState_.from));
+        boardView_.movePiece(moveState_.from, moveState_.to);
         if (moveState_.segmentCapturedPiecePos.isValid()) {
-            boardView_(moveState_.segmentCapturedPiecePos).setCaptured();
+            boardView_.setCaptured(moveState_.segmentCapturedPiecePos);
             moveState_.segmentCapturedPiecePos.reset();
         }
         selection_.origin = moveState_.to;
@@ -745,11 +827,15 @@ void PlayState::initializeEngine()
         return;
     }
 
-    if (gameContext_.engineMode == ENGINE_MODE::NOVICE) {
-        engine_ = std::make_unique<RandomEngine>(checkers_);
-    } else {
-        engine_ = std::make_unique<MinimaxEngine>(checkers_, gameContext_.engineMode);
-    }
+    const ENGINE_MODE engineMode = gameContext_.engineMode;
+    const auto factory = [engineMode](Checkers& snapshot) -> std::unique_ptr<Engine> {
+        if (engineMode == ENGINE_MODE::NOVICE) {
+            return std::make_unique<RandomEngine>(snapshot);
+        }
+        return std::make_unique<MinimaxEngine>(snapshot, engineMode);
+    };
+    engine_ = std::make_unique<AsyncEngine>(checkers_, factory, kEngineSearchMode);
+    engine_->setSlice(SearchSlice{.maxTime = searchSlice_});
 }
 
 int PlayState::getPieceRadiusOffset() const
@@ -809,6 +895,7 @@ void PlayState::updateLayoutMetrics()
 
 void PlayState::reset()
 {
+    cancelComputerSearch();
     stopResultSounds();
 
     checkers_.setCheckersType(gameContext_.checkersType);
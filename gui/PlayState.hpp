@@ -2,9 +2,11 @@
 
 #include <SFML/Audio.hpp>
 #include <SFML/Graphics.hpp>
+#include <chrono>
 #include <memory>
 #include <vector>
 
+#include "AsyncEngine.hpp"
 #include "Board.hpp"
 #include "Checkers.hpp"
 #include "Engine.hpp"
@@ -81,8 +83,12 @@ private:
     Checkers checkers_{};
     // Local board snapshot used for rendering/intermediate animation
     Board boardView_;
-    // Engine used for COMPUTER mode (null in TWO_PLAYERS mode)
-    std::unique_ptr<Engine> engine_{};
+    // Engine used for COMPUTER mode (null in TWO_PLAYERS mode); it thinks on a thread of its own, or in the
+    //   update() of every frame in LPC_SINGLE_THREADED builds
+    std::unique_ptr<AsyncEngine> engine_{};
+    // Time-sliced search: time between two updates, and the search time of one update fitted to it
+    sf::Clock frameClock_{};
+    std::chrono::microseconds searchSlice_{8000};
     // Current board selection state
     SelectionState selection_{};
     // Current move animation/commit state
@@ -186,8 +192,16 @@ private:
     void undoMove();
     // Handle redo shortcut
     void redoMove();
-    // Ask engine for move when it's computer's turn
+    // Start the engine search when it's computer's turn (or turn the ponder into it) and animate its move once
+    //   the search is done
     void triggerComputerMoveIfNeeded();
+    // Start the engine search on the position after the human's move as soon as the move is fully resolved,
+    //   while it is still being animated
+    void startComputerSearchForResolvedMove();
+    // Time-sliced search: shrink the search time per frame when frames get too long, grow it otherwise
+    void adaptSearchSlice();
+    // Drop a running engine search (the position it searches is going away)
+    void cancelComputerSearch();
     // Build/reset engine implementation based on selected mode/difficulty
     void initializeEngine();
     // Type-specific size tuning used to compute radius